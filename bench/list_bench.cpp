@@ -0,0 +1,251 @@
+#include "../common/do_not_optimize.h"
+#include "../dllist/dllist.h"
+#include "../linkedlist/linkedList.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <string>
+#include <vector>
+
+// Microbenchmarks for LinkedList and DoubleLinkedList against the standard
+// sequence containers. Every case reports nanoseconds per element operation
+// as CSV (default) or JSON lines.
+//
+//   list_bench [--json] [--max-size N]
+
+constexpr std::size_t kChurnOps = 1000;
+constexpr std::size_t kMiddleOps = 100;
+constexpr std::size_t kElementsPerCase = 1000000;
+
+// ============================================================== //
+// ======================== Operations ========================== //
+// ============================================================== //
+
+// Each container gets the cheapest form of an operation it supports. Churn
+// is a FIFO push/pop where the container allows it, otherwise LIFO.
+
+template <typename C> void bench_fill(C &c, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    c.push_back(int(i % 10));
+  }
+}
+
+void bench_fill(std::forward_list<int> &c, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    c.push_front(int(i % 10));
+  }
+}
+
+template <typename C> void bench_churn(C &c, int val) {
+  c.push_back(val);
+  do_not_optimize(c.pop_front());
+}
+
+template <typename T> void bench_churn(std::list<T> &c, int val) {
+  c.push_back(val);
+  c.pop_front();
+}
+
+template <typename T> void bench_churn(std::deque<T> &c, int val) {
+  c.push_back(val);
+  c.pop_front();
+}
+
+template <typename T> void bench_churn(std::forward_list<T> &c, int val) {
+  c.push_front(val);
+  c.pop_front();
+}
+
+template <typename T> void bench_churn(std::vector<T> &c, int val) {
+  c.push_back(val);
+  c.pop_back();
+}
+
+template <typename C> auto middle(C &c, std::size_t size) {
+  auto it = c.begin();
+  for (std::size_t i = 0; i < size / 2; ++i) {
+    ++it;
+  }
+  return it;
+}
+
+template <typename C, typename I> void bench_middle(C &c, I pos) {
+  for (std::size_t i = 0; i < kMiddleOps; ++i) {
+    pos = c.insert(pos, int(i));
+    pos = c.erase(pos);
+  }
+}
+
+template <typename T, typename I>
+void bench_middle(std::forward_list<T> &c, I pos) {
+  for (std::size_t i = 0; i < kMiddleOps; ++i) {
+    c.insert_after(pos, int(i));
+    c.erase_after(pos);
+  }
+}
+
+template <typename C> void bench_traverse(C &c) {
+  long long sum = 0;
+  for (auto it = c.begin(); it != c.end(); ++it) {
+    sum += *it;
+  }
+  do_not_optimize(sum);
+}
+
+template <typename C> void bench_remove(C &c) { c.remove(0); }
+
+template <typename T> void bench_remove(std::vector<T> &c) {
+  c.erase(std::remove(c.begin(), c.end(), 0), c.end());
+}
+
+template <typename T> void bench_remove(std::deque<T> &c) {
+  c.erase(std::remove(c.begin(), c.end(), 0), c.end());
+}
+
+// ============================================================== //
+// ========================== Harness =========================== //
+// ============================================================== //
+
+struct Options {
+  bool json = false;
+  std::size_t max_size = 10000000;
+};
+
+void report(const Options &options, const char *container, const char *op,
+            std::size_t size, double ns_per_op) {
+  if (options.json) {
+    std::printf("{\"container\":\"%s\",\"op\":\"%s\",\"size\":%zu,"
+                "\"ns_per_op\":%.3f}\n",
+                container, op, size, ns_per_op);
+  } else {
+    std::printf("%s,%s,%zu,%.3f\n", container, op, size, ns_per_op);
+  }
+}
+
+// Runs `body` on a freshly filled container enough times to cover roughly
+// kElementsPerCase elements or operations. `prepare` runs untimed before each
+// call and its result is passed to `body`. `ops` is the number of operations
+// one call of `body` performs.
+template <typename C, typename P, typename F>
+double measure(std::size_t size, std::size_t ops, P prepare, F body) {
+  const std::size_t reps =
+      std::max<std::size_t>(1, kElementsPerCase / std::max(size, ops));
+  std::chrono::steady_clock::duration total{};
+
+  for (std::size_t rep = 0; rep < reps; ++rep) {
+    C c;
+    bench_fill(c, size);
+    auto state = prepare(c);
+
+    auto start = std::chrono::steady_clock::now();
+    body(c, state);
+    total += std::chrono::steady_clock::now() - start;
+
+    c.clear();
+  }
+
+  return std::chrono::duration<double, std::nano>(total).count() /
+         double(reps * ops);
+}
+
+template <typename C, typename F>
+double measure(std::size_t size, std::size_t ops, F body) {
+  return measure<C>(
+      size, ops, [](C &) { return 0; }, [&body](C &c, int) { body(c); });
+}
+
+template <typename C, bool HasMiddle = true, bool HasRemove = true>
+void run_container(const Options &options, const char *name) {
+  for (std::size_t size = 10; size <= options.max_size; size *= 10) {
+    std::size_t reps = std::max<std::size_t>(1, kElementsPerCase / size);
+
+    std::chrono::steady_clock::duration fill_time{};
+    for (std::size_t rep = 0; rep < reps; ++rep) {
+      C c;
+      auto start = std::chrono::steady_clock::now();
+      bench_fill(c, size);
+      fill_time += std::chrono::steady_clock::now() - start;
+      c.clear();
+    }
+    report(options, name, "push", size,
+           std::chrono::duration<double, std::nano>(fill_time).count() /
+               double(reps * size));
+
+    report(options, name, "churn", size,
+           measure<C>(size, kChurnOps, [](C &c) {
+             for (std::size_t i = 0; i < kChurnOps; ++i) {
+               bench_churn(c, int(i));
+             }
+           }));
+
+    if constexpr (HasMiddle) {
+      report(options, name, "middle_insert_erase", size,
+             measure<C>(
+                 size, kMiddleOps, [size](C &c) { return middle(c, size); },
+                 [](C &c, auto pos) { bench_middle(c, pos); }));
+    }
+
+    report(options, name, "traverse", size,
+           measure<C>(size, size, [](C &c) { bench_traverse(c); }));
+
+    if constexpr (HasRemove) {
+      report(options, name, "remove", size,
+             measure<C>(size, size, [](C &c) { bench_remove(c); }));
+    }
+
+    report(options, name, "clear", size,
+           measure<C>(size, size, [](C &c) { c.clear(); }));
+  }
+}
+
+// Copy construction, timed including destroying the copy. Run as a separate
+// pass after every container's other cases: the single-block copies leave
+// the allocator in a different state, which would skew the push and
+// traverse numbers of the containers measured after them.
+template <typename C> void run_copy(const Options &options, const char *name) {
+  for (std::size_t size = 10; size <= options.max_size; size *= 10) {
+    report(options, name, "copy", size, measure<C>(size, size, [](C &c) {
+             C copy(c);
+             do_not_optimize(copy);
+           }));
+  }
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--json") == 0) {
+      options.json = true;
+    } else if (std::strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+      options.max_size = std::strtoull(argv[++i], nullptr, 10);
+    } else {
+      std::fprintf(stderr, "usage: %s [--json] [--max-size N]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if (!options.json) {
+    std::printf("container,op,size,ns_per_op\n");
+  }
+
+  // LinkedList has no insert/erase or remove.
+  run_container<LinkedList<int>, false, false>(options, "LinkedList");
+  run_container<DoubleLinkedList<int>>(options, "DoubleLinkedList");
+  run_container<std::list<int>>(options, "std::list");
+  run_container<std::forward_list<int>>(options, "std::forward_list");
+  run_container<std::deque<int>>(options, "std::deque");
+  run_container<std::vector<int>>(options, "std::vector");
+
+  run_copy<LinkedList<int>>(options, "LinkedList");
+  run_copy<DoubleLinkedList<int>>(options, "DoubleLinkedList");
+  run_copy<std::list<int>>(options, "std::list");
+  run_copy<std::forward_list<int>>(options, "std::forward_list");
+  run_copy<std::deque<int>>(options, "std::deque");
+  run_copy<std::vector<int>>(options, "std::vector");
+  return 0;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// Keeps the compiler from discarding a value computed inside a benchmark
+// loop, without the store a volatile sink would add.
+template <typename V> inline void do_not_optimize(V const &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
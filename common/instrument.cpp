@@ -0,0 +1,172 @@
+#include "instrument.h"
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+namespace {
+
+thread_local AllocationStats t_allocations;
+thread_local CountedStats t_counted;
+thread_local int t_throw_countdown = -1;
+
+void *allocate(std::size_t size) {
+  ++t_allocations.allocations;
+  t_allocations.bytes += size;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void *allocate(std::size_t size, std::align_val_t align) {
+  ++t_allocations.allocations;
+  t_allocations.bytes += size;
+
+  std::size_t alignment = static_cast<std::size_t>(align);
+  std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+  return std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded);
+}
+
+void deallocate(void *ptr) {
+  if (ptr != nullptr) {
+    ++t_allocations.deallocations;
+    std::free(ptr);
+  }
+}
+
+void *checked(void *ptr) {
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+} // namespace
+
+// ============================================================== //
+// ===================== operator new/delete ==================== //
+// ============================================================== //
+
+void *operator new(std::size_t size) { return checked(allocate(size)); }
+void *operator new[](std::size_t size) { return checked(allocate(size)); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+  return checked(allocate(size, align));
+}
+void *operator new[](std::size_t size, std::align_val_t align) {
+  return checked(allocate(size, align));
+}
+
+void *operator new(std::size_t size, std::align_val_t align,
+                   const std::nothrow_t &) noexcept {
+  return allocate(size, align);
+}
+void *operator new[](std::size_t size, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  return allocate(size, align);
+}
+
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { deallocate(ptr); }
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  deallocate(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+  deallocate(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  deallocate(ptr);
+}
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  deallocate(ptr);
+}
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  deallocate(ptr);
+}
+
+// ============================================================== //
+// ====================== AllocationScope ======================= //
+// ============================================================== //
+
+AllocationStats allocation_stats() { return t_allocations; }
+
+std::size_t AllocationScope::allocations() const {
+  return t_allocations.allocations - d_start.allocations;
+}
+
+std::size_t AllocationScope::deallocations() const {
+  return t_allocations.deallocations - d_start.deallocations;
+}
+
+std::size_t AllocationScope::bytes() const {
+  return t_allocations.bytes - d_start.bytes;
+}
+
+// ============================================================== //
+// ========================== Counted =========================== //
+// ============================================================== //
+
+Counted::Counted(int val) : d_val(val) { ++t_counted.constructions; }
+
+Counted::Counted(const Counted &other) : d_val(other.d_val) {
+  ++t_counted.copies;
+}
+
+Counted::Counted(Counted &&other) noexcept : d_val(other.d_val) {
+  ++t_counted.moves;
+}
+
+Counted &Counted::operator=(const Counted &other) {
+  d_val = other.d_val;
+  ++t_counted.copies;
+  return *this;
+}
+
+Counted &Counted::operator=(Counted &&other) noexcept {
+  d_val = other.d_val;
+  ++t_counted.moves;
+  return *this;
+}
+
+Counted::~Counted() { ++t_counted.destructions; }
+
+CountedStats Counted::stats() { return t_counted; }
+
+std::size_t CountedScope::constructions() const {
+  return t_counted.constructions - d_start.constructions;
+}
+
+std::size_t CountedScope::copies() const {
+  return t_counted.copies - d_start.copies;
+}
+
+std::size_t CountedScope::moves() const {
+  return t_counted.moves - d_start.moves;
+}
+
+std::size_t CountedScope::destructions() const {
+  return t_counted.destructions - d_start.destructions;
+}
+
+// ============================================================== //
+// ======================== ThrowingCopy ======================== //
+// ============================================================== //
+
+ThrowingCopy::ThrowingCopy(const ThrowingCopy &other) : d_val(other.d_val) {
+  if (t_throw_countdown >= 0 && t_throw_countdown-- == 0) {
+    throw std::runtime_error("ThrowingCopy: copy failed");
+  }
+}
+
+void ThrowingCopy::throw_after(int copies) { t_throw_countdown = copies; }
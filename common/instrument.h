@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+
+// Instrumentation for tests and benchmarks. Linking instrument.cpp replaces
+// the global operator new/delete with versions that count allocations per
+// thread, and `Counted` counts its own constructions, copies and moves.
+// `ThrowingCopy` fails a chosen copy to exercise exception paths.
+// Scopes snapshot the counters on construction and report the difference.
+
+// ============================================================== //
+// ======================== Allocations ========================= //
+// ============================================================== //
+
+struct AllocationStats {
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t bytes = 0;
+};
+
+// Totals for the calling thread since it started.
+AllocationStats allocation_stats();
+
+class AllocationScope {
+public:
+  AllocationScope() : d_start(allocation_stats()) {}
+
+  std::size_t allocations() const;
+  std::size_t deallocations() const;
+  std::size_t bytes() const;
+
+private:
+  AllocationStats d_start;
+};
+
+// ============================================================== //
+// ========================== Counted =========================== //
+// ============================================================== //
+
+struct CountedStats {
+  std::size_t constructions = 0;
+  std::size_t copies = 0;
+  std::size_t moves = 0;
+  std::size_t destructions = 0;
+};
+
+// Element type that records every construction, copy, move and destruction
+// on the calling thread. Assignments count as copies and moves.
+class Counted {
+public:
+  Counted(int val = 0);
+  Counted(const Counted &other);
+  Counted(Counted &&other) noexcept;
+  Counted &operator=(const Counted &other);
+  Counted &operator=(Counted &&other) noexcept;
+  ~Counted();
+
+  static CountedStats stats();
+
+  int value() const { return d_val; }
+
+  bool operator==(const Counted &other) const { return d_val == other.d_val; }
+  bool operator!=(const Counted &other) const { return d_val != other.d_val; }
+
+  friend std::ostream &operator<<(std::ostream &out, const Counted &val) {
+    out << "Counted(" << val.d_val << ")";
+    return out;
+  }
+
+private:
+  int d_val;
+};
+
+class CountedScope {
+public:
+  CountedScope() : d_start(Counted::stats()) {}
+
+  std::size_t constructions() const;
+  std::size_t copies() const;
+  std::size_t moves() const;
+  std::size_t destructions() const;
+
+private:
+  CountedStats d_start;
+};
+
+// ============================================================== //
+// ======================== ThrowingCopy ======================== //
+// ============================================================== //
+
+// Element type whose copy constructor throws std::runtime_error once armed
+// with throw_after(). It has no move constructor, so moves fail the same
+// way. The countdown is per thread, like the other counters.
+class ThrowingCopy {
+public:
+  ThrowingCopy(int val = 0) : d_val(val) {}
+  ThrowingCopy(const ThrowingCopy &other);
+  ThrowingCopy &operator=(const ThrowingCopy &other) = default;
+
+  // The copy after `copies` successful ones throws, a negative count
+  // disarms.
+  static void throw_after(int copies);
+
+  int value() const { return d_val; }
+
+  friend std::istream &operator>>(std::istream &in, ThrowingCopy &val) {
+    return in >> val.d_val;
+  }
+
+private:
+  int d_val;
+};
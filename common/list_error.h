@@ -0,0 +1,4 @@
+#pragma once
+
+// Error reported by the checked (try_*) operations of the list containers.
+enum class ListError { Empty };
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "instrument.h"
+#include "list_error.h"
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Checks shared by the LinkedList and DoubleLinkedList tests. `List` is the
+// list template, instantiated with the instrumented element types from
+// instrument.h. List-specific behaviour stays in each project's main.cpp.
+
+// ============================================================== //
+// ======================= Instrumented ========================= //
+// ============================================================== //
+
+// One allocation per pushed node, and no copies on the way in or out.
+template <template <typename> class List> void test_list_instrumented() {
+  List<Counted> list;
+
+  {
+    AllocationScope allocs;
+    CountedScope counted;
+    for (int i = 0; i < 4; ++i) {
+      list.push_back(Counted(i));
+    }
+    assert(allocs.allocations() == 4);
+    assert(counted.copies() == 0);
+  }
+
+  {
+    AllocationScope allocs;
+    CountedScope counted;
+    int sum = 0;
+    for (auto it = list.begin(); it != list.end(); ++it) {
+      sum += (*it).value();
+    }
+    assert(sum == 6);
+    assert(list.try_front().value().get() == Counted(0));
+    assert(list.try_back().value().get() == Counted(3));
+    assert(allocs.allocations() == 0);
+    assert(counted.copies() == 0);
+  }
+
+  {
+    AllocationScope allocs;
+    CountedScope counted;
+    Counted first = list.pop_front();
+    Counted last = list.pop_back();
+    auto second = list.try_pop_front();
+    auto third = list.try_pop_back();
+    auto none = list.try_pop_back();
+
+    assert(first == Counted(0));
+    assert(last == Counted(3));
+    assert(second.value() == Counted(1));
+    assert(third.value() == Counted(2));
+    assert(none.error() == ListError::Empty);
+    assert(allocs.allocations() == 0);
+    assert(allocs.deallocations() == 4);
+    assert(counted.copies() == 0);
+  }
+}
+
+// ============================================================== //
+// ======================== Copy / bulk ========================= //
+// ============================================================== //
+
+template <typename L> std::vector<int> list_values(L &list) {
+  std::vector<int> out;
+  for (auto it = list.begin(); it != list.end(); ++it) {
+    out.push_back((*it).value());
+  }
+  return out;
+}
+
+// Copies and bulk loads cost one allocation, moves none, and a throwing
+// element copy leaves the list untouched.
+template <template <typename> class List> void test_list_copy() {
+  std::cout << "Testing copy and bulk construction" << std::endl;
+
+  List<Counted> list = {0, 1, 2, 3, 4, 5, 6, 7};
+  {
+    AllocationScope allocs;
+    CountedScope counted;
+    List<Counted> copy(list);
+    assert(allocs.allocations() == 1);
+    assert(counted.copies() == 8);
+    assert(counted.moves() == 0);
+    assert(list_values(copy) == list_values(list));
+
+    // Nodes are independent, the copy can be modified freely.
+    copy.pop_front();
+    copy.push_back(Counted(8));
+    assert(list_values(copy) == std::vector<int>({1, 2, 3, 4, 5, 6, 7, 8}));
+    assert(list_values(list) == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}));
+  }
+
+  {
+    AllocationScope allocs;
+    List<Counted> moved(std::move(list));
+    assert(list.empty());
+    assert(allocs.allocations() == 0);
+
+    list = moved;
+    assert(allocs.allocations() == 1);
+    assert(list_values(list) == list_values(moved));
+
+    AllocationScope reassign;
+    moved = std::move(list);
+    assert(list.empty());
+    list = std::move(moved);
+    assert(moved.empty());
+    assert(reassign.allocations() == 0);
+    assert(reassign.deallocations() == 1);
+    assert(list_values(list) == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}));
+  }
+
+  {
+    // A surviving node pins its block until the list is rebuilt.
+    List<Counted> pinned = {0, 1, 2, 3};
+    pinned.pop_front();
+    pinned.pop_front();
+    pinned.pop_front();
+    AllocationScope allocs;
+    pinned = List<Counted>(pinned);
+    assert(allocs.allocations() == 1);
+    assert(allocs.deallocations() == 1);
+    assert(pinned.try_front().value().get() == Counted(3));
+  }
+
+  {
+    std::vector<int> vals = {10, 11, 12};
+    AllocationScope allocs;
+    list.assign(vals.begin(), vals.end());
+    list.append_range(vals);
+    list.push_back(Counted(13));
+    assert(allocs.allocations() == 3);
+    assert(allocs.deallocations() == 1);
+    assert(list_values(list) ==
+           std::vector<int>({10, 11, 12, 10, 11, 12, 13}));
+
+    // Single-pass input falls back to push_back.
+    std::istringstream in("20 21");
+    list.append(std::istream_iterator<int>(in), std::istream_iterator<int>());
+    assert(list_values(list).back() == 21);
+
+    list.assign({});
+    assert(list.empty());
+  }
+
+  {
+    // A list is a forward range itself, so copying between lists takes the
+    // bulk path.
+    static_assert(std::forward_iterator<decltype(list.begin())>);
+    static_assert(std::ranges::forward_range<List<Counted>>);
+    List<Counted> source = {20, 21, 22};
+    AllocationScope allocs;
+    List<Counted> built(source.begin(), source.end());
+    built.append_range(source);
+    assert(allocs.allocations() == 2);
+    assert(list_values(built) ==
+           std::vector<int>({20, 21, 22, 20, 21, 22}));
+  }
+
+  {
+    std::vector<ThrowingCopy> source = {0, 1, 2, 3};
+    List<ThrowingCopy> target = {7};
+    AllocationScope allocs;
+    ThrowingCopy::throw_after(2);
+    bool thrown = false;
+    try {
+      target.append_range(source);
+    } catch (const std::runtime_error &) {
+      thrown = true;
+    }
+    ThrowingCopy::throw_after(-1);
+    assert(thrown);
+    assert(list_values(target) == std::vector<int>({7}));
+    assert(allocs.allocations() == allocs.deallocations());
+  }
+
+  // Constructing from single-pass input links nodes one by one, a throw at
+  // any point must release the ones already linked.
+  for (int copies = 0; copies < 8; ++copies) {
+    std::istringstream in("0 1 2 3");
+    AllocationScope allocs;
+    ThrowingCopy::throw_after(copies);
+    try {
+      std::istream_iterator<ThrowingCopy> first(in), last;
+      List<ThrowingCopy> built(first, last);
+      assert(list_values(built) == std::vector<int>({0, 1, 2, 3}));
+    } catch (const std::runtime_error &) {
+    }
+    ThrowingCopy::throw_after(-1);
+    assert(allocs.allocations() == allocs.deallocations());
+  }
+}
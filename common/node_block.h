@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// ============================================================== //
+// ========================= NodeBlock ========================== //
+// ============================================================== //
+
+// Storage for a run of list nodes obtained with a single allocation, used by
+// the bulk operations of LinkedList and DoubleLinkedList (copy, range and
+// initializer-list construction, assign, append). Node needs a
+// `bool &pooled()` accessor, set for nodes built here. Each slot keeps a
+// pointer back to its block just in front of the node, so the block costs
+// nothing in nodes allocated with plain new.
+//
+// Slots are not reused once their node is destroyed and the block is freed
+// together with its last node. A list that was bulk loaded and then had all
+// but one node erased still holds the whole block, copying it into a fresh
+// list (`list = List(list)`) moves the survivors into a block of their own.
+template <typename Node> class NodeBlock {
+public:
+  // Builds a chain of `count` nodes in a new block. `make(block, idx)` must
+  // construct node `idx` with block.construct(idx, ...). Once all nodes
+  // exist, `link(prev, node)` joins each pair of neighbours. If a
+  // constructor throws, the nodes built so far are destroyed and nothing
+  // has been linked yet. Returns the first and last node, both null for an
+  // empty chain.
+  template <typename Make, typename Link>
+  static std::pair<Node *, Node *> build(std::size_t count, Make make,
+                                         Link link);
+
+  template <typename... Args> Node *construct(std::size_t idx, Args &&...args);
+
+  // Destroys a node built either in a block or with plain new.
+  static void destroy(Node *node);
+
+private:
+  static constexpr std::size_t kAlign =
+      alignof(Node) > alignof(NodeBlock *) ? alignof(Node)
+                                           : alignof(NodeBlock *);
+  // Header and slots are padded to kAlign, the back pointer ends right
+  // where the node starts.
+  static constexpr std::size_t kHeader =
+      (sizeof(std::size_t) + kAlign - 1) / kAlign * kAlign;
+  static constexpr std::size_t kPrefix =
+      (sizeof(NodeBlock *) + kAlign - 1) / kAlign * kAlign;
+  static constexpr std::size_t kStride =
+      kPrefix + (sizeof(Node) + kAlign - 1) / kAlign * kAlign;
+  static constexpr bool kOverAligned =
+      kAlign > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+  NodeBlock() = default;
+
+  unsigned char *slot(std::size_t idx) {
+    return reinterpret_cast<unsigned char *>(this) + kHeader + idx * kStride;
+  }
+  Node *node(std::size_t idx) {
+    return std::launder(reinterpret_cast<Node *>(slot(idx) + kPrefix));
+  }
+  static NodeBlock *&owner(Node *node) {
+    return *std::launder(reinterpret_cast<NodeBlock **>(
+        reinterpret_cast<unsigned char *>(node) - sizeof(NodeBlock *)));
+  }
+  static NodeBlock *create(std::size_t count);
+  void release();
+
+  // build() holds a reference of its own until every node is constructed,
+  // so a half built block stays alive while its nodes are destroyed.
+  std::size_t d_live = 1;
+};
+
+template <typename Node>
+template <typename Make, typename Link>
+std::pair<Node *, Node *> NodeBlock<Node>::build(std::size_t count, Make make,
+                                                 Link link) {
+  if (count == 0) {
+    return {nullptr, nullptr};
+  }
+
+  NodeBlock *block = create(count);
+  std::size_t built = 0;
+  try {
+    for (; built < count; ++built) {
+      make(*block, built);
+    }
+  } catch (...) {
+    for (std::size_t i = 0; i < built; ++i) {
+      destroy(block->node(i));
+    }
+    block->release();
+    throw;
+  }
+  block->release();
+
+  for (std::size_t i = 1; i < count; ++i) {
+    link(block->node(i - 1), block->node(i));
+  }
+  return {block->node(0), block->node(count - 1)};
+}
+
+template <typename Node>
+NodeBlock<Node> *NodeBlock<Node>::create(std::size_t count) {
+  std::size_t bytes = kHeader + count * kStride;
+  void *raw = kOverAligned ? ::operator new(bytes, std::align_val_t(kAlign))
+                           : ::operator new(bytes);
+  return new (raw) NodeBlock();
+}
+
+template <typename Node>
+template <typename... Args>
+Node *NodeBlock<Node>::construct(std::size_t idx, Args &&...args) {
+  unsigned char *node_at = slot(idx) + kPrefix;
+  Node *node = new (node_at) Node(std::forward<Args>(args)...);
+  new (node_at - sizeof(NodeBlock *)) NodeBlock *(this);
+  node->pooled() = true;
+  ++d_live;
+  return node;
+}
+
+template <typename Node> void NodeBlock<Node>::destroy(Node *node) {
+  if (!node->pooled()) {
+    delete node;
+    return;
+  }
+  NodeBlock *block = owner(node);
+  node->~Node();
+  block->release();
+}
+
+template <typename Node> void NodeBlock<Node>::release() {
+  if (--d_live != 0) {
+    return;
+  }
+  this->~NodeBlock();
+  if constexpr (kOverAligned) {
+    ::operator delete(this, std::align_val_t(kAlign));
+  } else {
+    ::operator delete(this);
+  }
+}
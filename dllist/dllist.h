@@ -1,7 +1,17 @@
+#pragma once
+
+#include "../common/list_error.h"
+#include "../common/node_block.h"
+#include "../expected/expected.h"
 #include <cmath>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <ostream>
+#include <ranges>
 #include <utility>
 
 // ============================================================== //
@@ -16,7 +26,30 @@ private:
   Node* d_left = nullptr;
   Node* d_right = nullptr;
 
+  // Appends `count` nodes holding successive `next()` results, all taken
+  // from one NodeBlock.
+  template <typename F> void append_block(std::size_t count, F next);
+
 public:
+  // Nodes created by copying, assign(), append() and append_range() share
+  // one NodeBlock (node_block.h describes when it is freed). push_back,
+  // push_front, emplace and insert allocate each node separately.
+  DoubleLinkedList() = default;
+  DoubleLinkedList(const DoubleLinkedList &o);
+  DoubleLinkedList(DoubleLinkedList &&o) noexcept;
+  template <std::input_iterator It> DoubleLinkedList(It first, It last);
+  DoubleLinkedList(std::initializer_list<T> values);
+  ~DoubleLinkedList() { clear(); }
+
+  // `o` is built by the caller's copy or move, swap() leaves it our old nodes.
+  DoubleLinkedList &operator=(DoubleLinkedList o) noexcept;
+  void swap(DoubleLinkedList &o) noexcept;
+
+  template <std::input_iterator It> void assign(It first, It last);
+  void assign(std::initializer_list<T> values);
+  template <std::ranges::input_range R> void append_range(R &&range);
+  template <std::input_iterator It> void append(It first, It last);
+
   bool empty() { return d_left == nullptr; }
   void clear();
   void remove(const T &val);
@@ -27,6 +60,12 @@ public:
   T pop_back();
   T pop_front();
 
+  Expected<std::reference_wrapper<T>, ListError> try_back();
+  Expected<std::reference_wrapper<T>, ListError> try_front();
+
+  Expected<T, ListError> try_pop_back();
+  Expected<T, ListError> try_pop_front();
+
   void push_back(T val);
   void push_front(T val);
 
@@ -46,26 +85,26 @@ public:
 template <typename T> class DoubleLinkedList<T>::Node {
 private:
   T d_val;
+  // Ahead of the two links, so a small T and the flag share one word.
+  bool d_pooled = false;
   Node *d_next = nullptr;
   Node *d_prev = nullptr;
 
 public:
   template <typename C = T>
-  Node(C val, Node *prev, Node *next)
-      : d_val(std::move(val)), d_prev(prev), d_next(next){};
-
-  ~Node() { 
-    std::cout << "Deleting Node" << std::endl; 
-  }
+  Node(C &&val, Node *prev, Node *next)
+      : d_val(std::forward<C>(val)), d_next(next), d_prev(prev){};
 
   const T &val() const { return d_val; }
   T &val() { return d_val; }
 
-  const Node *&next() const { return d_next; }
+  const Node *next() const { return d_next; }
   Node *&next() { return d_next; }
 
-  const Node *&prev() const { return d_prev; }
+  const Node *prev() const { return d_prev; }
   Node *&prev() { return d_prev; }
+
+  bool &pooled() { return d_pooled; }
 };
 
 // ============================================================== //
@@ -79,10 +118,17 @@ private:
   Node* d_node = nullptr;
 
 public:
+  // end() can't be decremented, so this is only a forward iterator.
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+
+  Iterator() = default;
   Iterator(Node* node) : d_node(node) {};
-  Iterator(const Iterator &o) : d_node(o.d_node) {};
 
-  const Iterator &operator++() {
+  Iterator &operator++() {
     if (d_node == nullptr) {
       return *this;
     }
@@ -91,7 +137,7 @@ public:
     return *this;
   }
 
-  const Iterator operator++(int) {
+  Iterator operator++(int) {
     Iterator old = *this;
     operator++();
     return old;
@@ -111,9 +157,7 @@ public:
     return old;
   }
 
-  const T &operator*() const { return d_node->val(); }
-
-  T &operator*() { return d_node->val(); }
+  T &operator*() const { return d_node->val(); }
 
   bool operator==(const Iterator &rhs) const { return d_node == rhs.d_node; }
 
@@ -124,11 +168,117 @@ public:
 // ======================= LinkedList =========================== //
 // ============================================================== //
 
+template <typename T>
+DoubleLinkedList<T>::DoubleLinkedList(const DoubleLinkedList &o) {
+  std::size_t count = 0;
+  for (const Node *node = o.d_left; node; node = node->next()) {
+    ++count;
+  }
+
+  const Node *node = o.d_left;
+  append_block(count, [&node]() -> const T & {
+    const T &val = node->val();
+    node = node->next();
+    return val;
+  });
+}
+
+template <typename T>
+DoubleLinkedList<T>::DoubleLinkedList(DoubleLinkedList &&o) noexcept
+    : d_left(std::exchange(o.d_left, nullptr)),
+      d_right(std::exchange(o.d_right, nullptr)) {}
+
+// d_left and d_right don't free anything on their own, delegating makes
+// ~DoubleLinkedList release the nodes append() linked before a throw.
+template <typename T>
+template <std::input_iterator It>
+DoubleLinkedList<T>::DoubleLinkedList(It first, It last)
+    : DoubleLinkedList() {
+  append(first, last);
+}
+
+template <typename T>
+DoubleLinkedList<T>::DoubleLinkedList(std::initializer_list<T> values)
+    : DoubleLinkedList() {
+  append(values.begin(), values.end());
+}
+
+template <typename T>
+DoubleLinkedList<T> &
+DoubleLinkedList<T>::operator=(DoubleLinkedList o) noexcept {
+  swap(o);
+  return *this;
+}
+
+template <typename T>
+void DoubleLinkedList<T>::swap(DoubleLinkedList &o) noexcept {
+  std::swap(d_left, o.d_left);
+  std::swap(d_right, o.d_right);
+}
+
+template <typename T>
+template <std::input_iterator It>
+void DoubleLinkedList<T>::assign(It first, It last) {
+  DoubleLinkedList tmp(first, last);
+  swap(tmp);
+}
+
+template <typename T>
+void DoubleLinkedList<T>::assign(std::initializer_list<T> values) {
+  assign(values.begin(), values.end());
+}
+
+template <typename T>
+template <std::ranges::input_range R>
+void DoubleLinkedList<T>::append_range(R &&range) {
+  append(std::ranges::begin(range), std::ranges::end(range));
+}
+
+// std::distance would consume a single-pass range, so only forward iterators
+// are sized up front and built in one block.
+template <typename T>
+template <std::input_iterator It>
+void DoubleLinkedList<T>::append(It first, It last) {
+  if constexpr (std::forward_iterator<It>) {
+    append_block(std::distance(first, last),
+                 [&first]() -> decltype(auto) { return *first++; });
+  } else {
+    for (; first != last; ++first) {
+      push_back(*first);
+    }
+  }
+}
+
+template <typename T>
+template <typename F>
+void DoubleLinkedList<T>::append_block(std::size_t count, F next) {
+  auto [first, last] = NodeBlock<Node>::build(
+      count,
+      [&next](NodeBlock<Node> &block, std::size_t idx) {
+        block.construct(idx, next(), nullptr, nullptr);
+      },
+      [](Node *prev, Node *node) {
+        prev->next() = node;
+        node->prev() = prev;
+      });
+  if (first == nullptr) {
+    return;
+  }
+
+  if (empty()) {
+    d_left = first;
+  } else {
+    d_right->next() = first;
+    first->prev() = d_right;
+  }
+  d_right = last;
+}
+
 template <typename T> void DoubleLinkedList<T>::clear() {
   Node* current = d_left;
   while (current) {
     Node* nextNode = current->next();
-    delete current;
+    NodeBlock<Node>::destroy(current);
     current = nextNode;
   }
   d_left = d_right = nullptr;
@@ -138,6 +288,24 @@ template <typename T> T &DoubleLinkedList<T>::front() { return d_left->val(); }
 
 template <typename T> T &DoubleLinkedList<T>::back() { return d_right->val(); }
 
+template <typename T>
+Expected<std::reference_wrapper<T>, ListError>
+DoubleLinkedList<T>::try_front() {
+  if (empty()) {
+    return ListError::Empty;
+  }
+  return std::ref(d_left->val());
+}
+
+template <typename T>
+Expected<std::reference_wrapper<T>, ListError>
+DoubleLinkedList<T>::try_back() {
+  if (empty()) {
+    return ListError::Empty;
+  }
+  return std::ref(d_right->val());
+}
+
 template <typename T>
 typename DoubleLinkedList<T>::Iterator
 DoubleLinkedList<T>::insert(const DoubleLinkedList<T>::Iterator &pos,
@@ -195,7 +363,7 @@ DoubleLinkedList<T>::erase(const DoubleLinkedList<T>::Iterator &pos) {
     d_right = prev;
   }
 
-  delete node;
+  NodeBlock<Node>::destroy(node);
   return Iterator(next);
   //
   // if (prev == nullptr && next == nullptr) {
@@ -235,7 +403,7 @@ template <typename T> T DoubleLinkedList<T>::pop_back() {
     d_left = nullptr;
   }
   
-  delete temp;
+  NodeBlock<Node>::destroy(temp);
   return val;
 }
 
@@ -283,6 +451,22 @@ template <typename T> T DoubleLinkedList<T>::pop_front() {
     d_right = nullptr;
   }
 
-  delete temp;
+  NodeBlock<Node>::destroy(temp);
   return val;
 }
+
+template <typename T>
+Expected<T, ListError> DoubleLinkedList<T>::try_pop_back() {
+  if (empty()) {
+    return ListError::Empty;
+  }
+  return pop_back();
+}
+
+template <typename T>
+Expected<T, ListError> DoubleLinkedList<T>::try_pop_front() {
+  if (empty()) {
+    return ListError::Empty;
+  }
+  return pop_front();
+}
@@ -1,52 +1,132 @@
+#include "../common/instrument.h"
+#include "../common/list_tests.h"
 #include "dllist.h"
-#include <_stdlib.h>
+#include "rcu_dllist.h"
+#include <atomic>
+#include <cassert>
 #include <ios>
 #include <iostream>
-
-int object_count = 0;
-
-class Test {
-public:
-  Test(int a, std::string b) : d_a(a), d_b(b), d_id(object_count++) {
-    std::cout << "Constructed: " << *this;
-  }
-
-  Test(const Test &other)
-      : d_a(other.d_a), d_b(other.d_b), d_id(object_count++) {
-    std::cout << "Copy Constructed: " << *this;
-  };
-
-  Test(Test &&other)
-      : d_a(std::move(other.d_a)), d_b(std::move(other.d_b)),
-        d_id(object_count++) {
-    std::cout << "Move Constructed: " << *this;
-  };
-
-  Test &operator=(Test &&) {
-    std::cout << "Move Assigned: " << *this;
-    return *this;
+#include <thread>
+#include <vector>
+
+template <typename L> std::vector<int> snapshot(const L &list) {
+  std::vector<int> values;
+  auto guard = list.read();
+  for (auto it = guard.begin(); it != guard.end(); ++it) {
+    values.push_back((*it).value());
   }
+  return values;
+}
 
-  Test &operator=(const Test &other) {
-    std::cout << "Copy Assigned: " << *this;
-    return *this;
+void test_rcu() {
+  CountedScope counted;
+  {
+    RcuDoubleLinkedList<Counted> list;
+    list.push_back(Counted(2));
+    list.push_back(Counted(4));
+    list.push_front(Counted(1));
+    auto it = list.begin();
+    ++it;
+    ++it;
+    list.insert(it, Counted(3));
+    list.insert(list.end(), Counted(5));
+    assert(snapshot(list) == std::vector<int>({1, 2, 3, 4, 5}));
+    assert(list.size() == 5);
+
+    {
+      // Nodes erased while a reader is active survive reclaim().
+      auto guard = list.read();
+      auto first = guard.begin();
+      list.remove(Counted(1));
+      list.erase(list.begin());
+      assert(list.reclaim() == 0);
+      assert((*first).value() == 1);
+      assert((*++first).value() == 2);
+    }
+    assert(list.reclaim() == 2);
+    assert(list.retired() == 0);
+    assert(snapshot(list) == std::vector<int>({3, 4, 5}));
+
+    assert(list.pop_front().value() == 3);
+    assert(list.pop_back().value() == 5);
+    assert(snapshot(list) == std::vector<int>({4}));
+
+    {
+      // A pinned backlog is rescanned only after it doubled: 200 retirements
+      // trigger scans at 64 and 128, the next one is due at 256.
+      auto guard = list.read();
+      for (int i = 0; i < 200; ++i) {
+        list.push_back(Counted(i));
+        list.pop_back();
+      }
+      assert(list.retired() == 200);
+    }
+    list.push_back(Counted(0));
+    list.pop_back();
+    assert(list.retired() == 201);
+    assert(list.reclaim() == 201);
+
+    // Writer keeps the list sorted, every scan must see ascending values.
+    std::atomic<bool> done = false;
+    std::atomic<int> bad_scans = 0;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+      readers.emplace_back([&] {
+        while (!done.load()) {
+          auto values = snapshot(list);
+          for (std::size_t j = 1; j < values.size(); ++j) {
+            if (values[j - 1] >= values[j]) {
+              ++bad_scans;
+            }
+          }
+        }
+      });
+    }
+
+    for (int i = 5; i < 20000; ++i) {
+      list.push_back(Counted(i));
+      if (list.size() > 100) {
+        list.pop_front();
+      }
+      if (i % 7 == 0) {
+        auto it = list.begin();
+        ++it;
+        list.erase(it);
+      }
+    }
+    done = true;
+    for (auto &reader : readers) {
+      reader.join();
+    }
+    assert(bad_scans == 0);
+
+    list.clear();
+    assert(list.empty());
+    list.reclaim();
+    assert(list.retired() == 0);
   }
+  assert(counted.constructions() + counted.copies() + counted.moves() ==
+         counted.destructions());
+}
 
-  ~Test() { std::cout << "Destructed: " << *this; }
+// Bulk-loaded nodes get their prev links, also across blocks.
+void test_copy_links() {
+  DoubleLinkedList<Counted> list = {0, 1, 2};
+  DoubleLinkedList<Counted> copy(list);
+  copy.append_range(std::vector<int>({3, 4}));
 
-  friend std::ostream &operator<<(std::ostream &out, const Test &val) {
-    out << "Test(" << val.d_id << ")" << std::endl;
-    return out;
+  for (int i = 4; i >= 0; --i) {
+    assert(copy.pop_back().value() == i);
   }
-
-private:
-  int d_a;
-  std::string d_b;
-  int d_id;
-};
+  assert(copy.empty());
+}
 
 int main() {
   std::cout << "Hello Word" << std::endl;
+  test_list_instrumented<DoubleLinkedList>();
+  test_list_copy<DoubleLinkedList>();
+  test_copy_links();
+  test_rcu();
 
   DoubleLinkedList<int> list;
   list.push_back(1);
@@ -87,6 +167,18 @@ int main() {
     std::cout << (*it) << std::endl;
   }
 
+  list.back() = 4;
+  assert(list.try_back().value() == 4);
+  assert(list.try_pop_back().value() == 4);
+
+  std::cout << "Draining" << std::endl;
+  while (auto val = list.try_pop_front()) {
+    std::cout << val.value() << std::endl;
+  }
+  assert(list.empty());
+  assert(list.try_front().error() == ListError::Empty);
+  assert(list.try_pop_back().error() == ListError::Empty);
+
   list.clear();
   return 0;
 }
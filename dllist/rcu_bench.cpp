@@ -0,0 +1,133 @@
+#include "../common/do_not_optimize.h"
+#include "dllist.h"
+#include "rcu_dllist.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+// Writer latency while reader threads scan the list back to back. Compares
+// DoubleLinkedList behind a std::shared_mutex, where every scan holds the
+// lock, with RcuDoubleLinkedList, where scans take no lock. The writer
+// appends one element and drops the oldest per operation. Prints CSV with
+// latency percentiles in nanoseconds.
+//
+//   rcu_bench [readers] [list_size]
+
+constexpr int kWriterOps = 20000;
+
+struct Config {
+  int readers = 4;
+  int size = 10000;
+};
+
+void report(const char *mode, const Config &config,
+            std::vector<long long> &latencies) {
+  std::sort(latencies.begin(), latencies.end());
+  auto at = [&latencies](double q) {
+    return latencies[std::size_t(q * (latencies.size() - 1))];
+  };
+  std::printf("%s,%d,%d,%lld,%lld,%lld,%lld,%lld\n", mode, config.readers,
+              config.size, at(0.5), at(0.9), at(0.99), at(0.999),
+              latencies.back());
+}
+
+template <typename Scan, typename Write>
+std::vector<long long> run(const Config &config, Scan scan, Write write) {
+  std::atomic<bool> done = false;
+  std::vector<std::thread> readers;
+  for (int i = 0; i < config.readers; ++i) {
+    readers.emplace_back([&] {
+      while (!done.load(std::memory_order_relaxed)) {
+        do_not_optimize(scan());
+        std::this_thread::yield();
+      }
+    });
+  }
+
+  std::vector<long long> latencies;
+  latencies.reserve(kWriterOps);
+  for (int i = 0; i < kWriterOps; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    write(config.size + i);
+    auto stop = std::chrono::steady_clock::now();
+    latencies.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start)
+            .count());
+  }
+
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  return latencies;
+}
+
+void bench_rwlock(const Config &config) {
+  DoubleLinkedList<int> list;
+  std::shared_mutex mutex;
+  for (int i = 0; i < config.size; ++i) {
+    list.push_back(i);
+  }
+
+  auto latencies = run(
+      config,
+      [&] {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        long long sum = 0;
+        for (auto it = list.begin(); it != list.end(); ++it) {
+          sum += *it;
+        }
+        return sum;
+      },
+      [&](int val) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        list.push_back(val);
+        list.pop_front();
+      });
+  report("rwlock", config, latencies);
+  list.clear();
+}
+
+void bench_rcu(const Config &config) {
+  RcuDoubleLinkedList<int> list;
+  for (int i = 0; i < config.size; ++i) {
+    list.push_back(i);
+  }
+
+  auto latencies = run(
+      config,
+      [&] {
+        auto guard = list.read();
+        long long sum = 0;
+        for (auto it = guard.begin(); it != guard.end(); ++it) {
+          sum += *it;
+        }
+        return sum;
+      },
+      [&](int val) {
+        list.push_back(val);
+        list.pop_front();
+      });
+  report("rcu", config, latencies);
+}
+
+int main(int argc, char **argv) {
+  Config config;
+  if (argc > 1) {
+    config.readers = std::atoi(argv[1]);
+  }
+  if (argc > 2) {
+    config.size = std::atoi(argv[2]);
+  }
+
+  std::printf("mode,readers,size,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n");
+  bench_rwlock(config);
+  bench_rcu(config);
+  return 0;
+}
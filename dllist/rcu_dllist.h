@@ -0,0 +1,420 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <utility>
+
+// ============================================================== //
+// ==================== RcuDoubleLinkedList ===================== //
+// ============================================================== //
+
+// DoubleLinkedList variant where readers traverse without locks while a
+// single writer thread keeps inserting and erasing. Readers iterate inside a
+// ReadGuard, which publishes the epoch they started in. Erased nodes are
+// retired with the epoch of their removal and only freed once no reader
+// from that epoch or earlier is still active (epoch-based reclamation).
+//
+// A reader sees each node that stays linked for the whole scan, nodes
+// inserted or erased during the scan may or may not be visited. Readers
+// only get const access, the writer never modifies a linked value in place.
+// All non-const members are writer-only and must not be called
+// concurrently with each other.
+template <typename T> class RcuDoubleLinkedList {
+  class Node;
+
+public:
+  class Iterator;
+  class ConstIterator;
+  class ReadGuard;
+
+  RcuDoubleLinkedList() = default;
+  ~RcuDoubleLinkedList();
+
+  RcuDoubleLinkedList(const RcuDoubleLinkedList &) = delete;
+  RcuDoubleLinkedList &operator=(const RcuDoubleLinkedList &) = delete;
+
+  // Writer side
+  bool empty() const { return d_size == 0; }
+  std::size_t size() const { return d_size; }
+
+  void push_back(T val);
+  void push_front(T val);
+
+  // Readers may still be looking at the node, so the value is copied out.
+  T pop_back();
+  T pop_front();
+
+  Iterator begin() { return Iterator(d_left.load(std::memory_order_relaxed)); }
+  Iterator end() { return Iterator(nullptr); }
+  Iterator insert(const Iterator &pos, T val);
+  Iterator erase(const Iterator &pos);
+
+  void remove(const T &val);
+  void clear();
+
+  // Frees retired nodes that no active reader can reach, returns how many.
+  std::size_t reclaim();
+  std::size_t retired() const { return d_retired.size(); }
+
+  // Reader side, safe from any thread.
+  ReadGuard read() const { return ReadGuard(*this); }
+
+private:
+  static constexpr std::size_t kMaxReaders = 64;
+  static constexpr std::size_t kReclaimThreshold = 64;
+  static constexpr std::size_t kFreePerRetire = 2;
+  static constexpr std::uint64_t kIdle = 0;
+
+  struct alignas(64) ReaderSlot {
+    std::atomic<std::uint64_t> epoch{kIdle};
+  };
+
+  void unlink(Node *node);
+  void retire(Node *node);
+  void scan();
+  std::size_t free_safe(std::size_t count);
+
+  std::atomic<Node *> d_left{nullptr};
+  Node *d_right = nullptr;
+  std::size_t d_size = 0;
+
+  std::atomic<std::uint64_t> d_epoch{1};
+  // Ordered by retire epoch, the first d_safe entries are unreachable.
+  std::deque<std::pair<Node *, std::uint64_t>> d_retired;
+  std::size_t d_safe = 0;
+  std::size_t d_scan_at = kReclaimThreshold;
+  mutable ReaderSlot d_readers[kMaxReaders];
+};
+
+// ============================================================== //
+// =========================== Node ============================= //
+// ============================================================== //
+
+template <typename T> class RcuDoubleLinkedList<T>::Node {
+private:
+  T d_val;
+  std::atomic<Node *> d_next;
+  Node *d_prev;
+
+public:
+  Node(T val, Node *prev, Node *next)
+      : d_val(std::move(val)), d_next(next), d_prev(prev) {}
+
+  const T &val() const { return d_val; }
+
+  std::atomic<Node *> &next() { return d_next; }
+  const std::atomic<Node *> &next() const { return d_next; }
+
+  Node *&prev() { return d_prev; }
+};
+
+// ============================================================== //
+// ========================= ITERATORS ========================== //
+// ============================================================== //
+
+// Writer-side iterator over the live list.
+template <typename T> class RcuDoubleLinkedList<T>::Iterator {
+  friend RcuDoubleLinkedList;
+
+private:
+  Node *d_node = nullptr;
+
+public:
+  Iterator(Node *node) : d_node(node) {}
+
+  const Iterator &operator++() {
+    if (d_node != nullptr) {
+      d_node = d_node->next().load(std::memory_order_relaxed);
+    }
+    return *this;
+  }
+
+  const Iterator operator++(int) {
+    Iterator old = *this;
+    operator++();
+    return old;
+  }
+
+  const T &operator*() const { return d_node->val(); }
+
+  bool operator==(const Iterator &rhs) const { return d_node == rhs.d_node; }
+  bool operator!=(const Iterator &rhs) const { return d_node != rhs.d_node; }
+};
+
+// Reader-side iterator, only valid while its ReadGuard is alive.
+template <typename T> class RcuDoubleLinkedList<T>::ConstIterator {
+private:
+  const Node *d_node = nullptr;
+
+public:
+  ConstIterator(const Node *node) : d_node(node) {}
+
+  const ConstIterator &operator++() {
+    if (d_node != nullptr) {
+      d_node = d_node->next().load(std::memory_order_acquire);
+    }
+    return *this;
+  }
+
+  const ConstIterator operator++(int) {
+    ConstIterator old = *this;
+    operator++();
+    return old;
+  }
+
+  const T &operator*() const { return d_node->val(); }
+
+  bool operator==(const ConstIterator &rhs) const {
+    return d_node == rhs.d_node;
+  }
+  bool operator!=(const ConstIterator &rhs) const {
+    return d_node != rhs.d_node;
+  }
+};
+
+// ============================================================== //
+// ========================= ReadGuard ========================== //
+// ============================================================== //
+
+// Claims a reader slot for the lifetime of the guard. Waits if all
+// kMaxReaders slots are taken.
+template <typename T> class RcuDoubleLinkedList<T>::ReadGuard {
+  friend RcuDoubleLinkedList;
+
+private:
+  const RcuDoubleLinkedList *d_list;
+  ReaderSlot *d_slot = nullptr;
+
+  explicit ReadGuard(const RcuDoubleLinkedList &list) : d_list(&list) {
+    std::uint64_t epoch = list.d_epoch.load();
+    std::size_t start =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) % kMaxReaders;
+
+    while (d_slot == nullptr) {
+      for (std::size_t i = 0; i < kMaxReaders; ++i) {
+        ReaderSlot &slot = list.d_readers[(start + i) % kMaxReaders];
+        std::uint64_t idle = kIdle;
+        if (slot.epoch.compare_exchange_strong(idle, epoch)) {
+          d_slot = &slot;
+          break;
+        }
+      }
+      if (d_slot == nullptr) {
+        std::this_thread::yield();
+      }
+    }
+
+    // Order the published epoch before any load of the list.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+public:
+  ReadGuard(ReadGuard &&o) : d_list(o.d_list), d_slot(o.d_slot) {
+    o.d_slot = nullptr;
+  }
+  ReadGuard(const ReadGuard &) = delete;
+  ReadGuard &operator=(const ReadGuard &) = delete;
+
+  ~ReadGuard() {
+    if (d_slot != nullptr) {
+      d_slot->epoch.store(kIdle, std::memory_order_release);
+    }
+  }
+
+  ConstIterator begin() const {
+    return ConstIterator(d_list->d_left.load(std::memory_order_acquire));
+  }
+  ConstIterator end() const { return ConstIterator(nullptr); }
+};
+
+// ============================================================== //
+// ==================== RcuDoubleLinkedList ===================== //
+// ============================================================== //
+
+template <typename T> RcuDoubleLinkedList<T>::~RcuDoubleLinkedList() {
+  Node *current = d_left.load(std::memory_order_relaxed);
+  while (current) {
+    Node *next = current->next().load(std::memory_order_relaxed);
+    delete current;
+    current = next;
+  }
+
+  for (auto &[node, epoch] : d_retired) {
+    delete node;
+  }
+}
+
+template <typename T> void RcuDoubleLinkedList<T>::push_back(T val) {
+  Node *newNode = new Node(std::move(val), d_right, nullptr);
+
+  if (d_right == nullptr) {
+    d_left.store(newNode, std::memory_order_release);
+  } else {
+    d_right->next().store(newNode, std::memory_order_release);
+  }
+  d_right = newNode;
+  ++d_size;
+}
+
+template <typename T> void RcuDoubleLinkedList<T>::push_front(T val) {
+  Node *left = d_left.load(std::memory_order_relaxed);
+  Node *newNode = new Node(std::move(val), nullptr, left);
+
+  if (left == nullptr) {
+    d_right = newNode;
+  } else {
+    left->prev() = newNode;
+  }
+  d_left.store(newNode, std::memory_order_release);
+  ++d_size;
+}
+
+template <typename T> T RcuDoubleLinkedList<T>::pop_back() {
+  Node *node = d_right;
+  T val = node->val();
+  unlink(node);
+  retire(node);
+  return val;
+}
+
+template <typename T> T RcuDoubleLinkedList<T>::pop_front() {
+  Node *node = d_left.load(std::memory_order_relaxed);
+  T val = node->val();
+  unlink(node);
+  retire(node);
+  return val;
+}
+
+template <typename T>
+typename RcuDoubleLinkedList<T>::Iterator
+RcuDoubleLinkedList<T>::insert(const Iterator &pos, T val) {
+  if (pos == end()) {
+    push_back(std::move(val));
+    return Iterator(d_right);
+  }
+
+  Node *node = pos.d_node;
+  Node *prev = node->prev();
+  Node *newNode = new Node(std::move(val), prev, node);
+
+  if (prev == nullptr) {
+    d_left.store(newNode, std::memory_order_release);
+  } else {
+    prev->next().store(newNode, std::memory_order_release);
+  }
+  node->prev() = newNode;
+  ++d_size;
+  return Iterator(newNode);
+}
+
+template <typename T>
+typename RcuDoubleLinkedList<T>::Iterator
+RcuDoubleLinkedList<T>::erase(const Iterator &pos) {
+  Node *node = pos.d_node;
+  if (!node) {
+    return end();
+  }
+
+  Node *next = node->next().load(std::memory_order_relaxed);
+  unlink(node);
+  retire(node);
+  return Iterator(next);
+}
+
+template <typename T> void RcuDoubleLinkedList<T>::remove(const T &val) {
+  auto it = begin();
+  while (it != end()) {
+    if (*it == val) {
+      it = erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
+template <typename T> void RcuDoubleLinkedList<T>::clear() {
+  while (!empty()) {
+    Node *node = d_left.load(std::memory_order_relaxed);
+    unlink(node);
+    retire(node);
+  }
+}
+
+// Readers still on `node` keep following its next pointer, so it is left
+// untouched.
+template <typename T> void RcuDoubleLinkedList<T>::unlink(Node *node) {
+  Node *prev = node->prev();
+  Node *next = node->next().load(std::memory_order_relaxed);
+
+  if (prev) {
+    prev->next().store(next, std::memory_order_release);
+  } else {
+    d_left.store(next, std::memory_order_release);
+  }
+
+  if (next) {
+    next->prev() = prev;
+  } else {
+    d_right = prev;
+  }
+  --d_size;
+}
+
+// Freeing is spread over later retirements, kFreePerRetire nodes at a time,
+// so no single writer operation pays for a whole batch.
+template <typename T> void RcuDoubleLinkedList<T>::retire(Node *node) {
+  d_retired.emplace_back(node, d_epoch.fetch_add(1));
+  if (d_safe == 0 && d_retired.size() >= d_scan_at) {
+    scan();
+  }
+  free_safe(kFreePerRetire);
+}
+
+template <typename T> std::size_t RcuDoubleLinkedList<T>::reclaim() {
+  scan();
+  return free_safe(d_safe);
+}
+
+template <typename T> void RcuDoubleLinkedList<T>::scan() {
+  // Order the unlinks before reading the reader slots.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+  for (const ReaderSlot &slot : d_readers) {
+    std::uint64_t epoch = slot.epoch.load(std::memory_order_acquire);
+    if (epoch != kIdle) {
+      oldest = std::min(oldest, epoch);
+    }
+  }
+
+  // A node retired in epoch e may be reachable by readers that started in
+  // epoch e or earlier.
+  auto reachable = std::partition_point(
+      d_retired.begin(), d_retired.end(),
+      [oldest](const std::pair<Node *, std::uint64_t> &entry) {
+        return entry.second < oldest;
+      });
+  d_safe = std::distance(d_retired.begin(), reachable);
+
+  // A long-lived reader pins everything retired after it. Wait for the
+  // pinned backlog to double before scanning again, so the writer pays
+  // O(1) amortized per retirement instead of O(backlog).
+  d_scan_at = std::max(kReclaimThreshold, 2 * (d_retired.size() - d_safe));
+}
+
+template <typename T>
+std::size_t RcuDoubleLinkedList<T>::free_safe(std::size_t count) {
+  count = std::min(count, d_safe);
+  for (std::size_t i = 0; i < count; ++i) {
+    delete d_retired.front().first;
+    d_retired.pop_front();
+  }
+  d_safe -= count;
+  return count;
+}
@@ -0,0 +1,51 @@
+#include "error_workloads.h"
+#include "expected.h"
+#include <cstdio>
+#include <vector>
+
+// Compares three ways of propagating a failure up a call chain of `depth`
+// frames: manual checks on Expected, co_await on Expected and exceptions.
+// The manual and exception chains are the error_bench workloads, only the
+// coroutine chain is specific to this benchmark.
+
+constexpr int kIterations = 200000;
+
+// ============================================================== //
+// ========================= Workloads ========================== //
+// ============================================================== //
+
+// expected_chain with every check replaced by co_await.
+[[gnu::noinline]] Expected<int, ErrCode> coroutine_chain(int input,
+                                                         int depth) {
+  if (depth == 0) {
+    if (input < 0) {
+      co_return ErrCode::Invalid;
+    }
+    co_return input;
+  }
+  int val = co_await coroutine_chain(input, depth - 1);
+  co_return val + 1;
+}
+
+int run_coroutine(int input, int depth) {
+  return coroutine_chain(input, depth).value_or(-1);
+}
+
+// ============================================================== //
+// ========================== Harness =========================== //
+// ============================================================== //
+
+int main() {
+  std::printf("depth,fail_percent,manual_ns,coroutine_ns,exception_ns\n");
+
+  for (int depth : {1, 4, 16}) {
+    for (int fail_percent : {0, 1, 10, 50}) {
+      auto inputs = make_inputs(kIterations, fail_percent);
+      std::printf("%d,%d,%.2f,%.2f,%.2f\n", depth, fail_percent,
+                  ns_per_op(inputs, depth, run_expected),
+                  ns_per_op(inputs, depth, run_coroutine),
+                  ns_per_op(inputs, depth, run_exception));
+    }
+  }
+  return 0;
+}
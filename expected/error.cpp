@@ -0,0 +1,41 @@
+#include "error.h"
+
+std::string Error::message() const {
+  const char *fmt = d_category->format(d_code);
+  if (fmt == nullptr) {
+    return std::string(d_category->name()) + ":" + std::to_string(d_code);
+  }
+
+  std::string out;
+  std::size_t next = 0;
+  for (const char *c = fmt; *c != '\0'; ++c) {
+    if (c[0] == '{' && c[1] == '}' && next < d_argc) {
+      out += std::to_string(d_args[next++]);
+      ++c;
+    } else {
+      out += *c;
+    }
+  }
+  return out;
+}
+
+bool Error::operator==(const Error &other) const {
+  if (d_category != other.d_category || d_code != other.d_code ||
+      d_argc != other.d_argc) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < d_argc; ++i) {
+    if (d_args[i] != other.d_args[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Error::operator!=(const Error &other) const { return !(*this == other); }
+
+std::ostream &operator<<(std::ostream &out, const Error &error) {
+  out << error.message();
+  return out;
+}
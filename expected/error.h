@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// ============================================================== //
+// ======================= ErrorCategory ======================== //
+// ============================================================== //
+
+// A category maps error codes to format strings. Categories are expected to
+// be long-lived singletons, errors only keep a pointer to them.
+class ErrorCategory {
+public:
+  virtual ~ErrorCategory() = default;
+
+  virtual const char *name() const = 0;
+
+  // Format string for `code`. Every "{}" is replaced with the next argument
+  // stored in the error when the message is requested.
+  virtual const char *format(int code) const = 0;
+};
+
+// ============================================================== //
+// =========================== Error ============================ //
+// ============================================================== //
+
+// Compact error payload for use as `E` in `Expected<T, E>`. Holds a code, a
+// category and a few integral arguments inline, the message is only built
+// when `message()` is called so the failure path never allocates.
+class Error {
+public:
+  static constexpr std::size_t kMaxArgs = 3;
+
+  template <typename... Args>
+  Error(int code, const ErrorCategory &category, Args... args);
+
+  int code() const { return d_code; }
+  const ErrorCategory &category() const { return *d_category; }
+
+  std::size_t arg_count() const { return d_argc; }
+  std::int64_t arg(std::size_t idx) const { return d_args[idx]; }
+
+  std::string message() const;
+
+  bool operator==(const Error &other) const;
+  bool operator!=(const Error &other) const;
+
+  friend std::ostream &operator<<(std::ostream &out, const Error &error);
+
+private:
+  const ErrorCategory *d_category;
+  std::int64_t d_args[kMaxArgs] = {};
+  std::int32_t d_code;
+  std::uint8_t d_argc;
+};
+
+static_assert(std::is_trivially_copyable_v<Error>);
+
+template <typename... Args>
+Error::Error(int code, const ErrorCategory &category, Args... args)
+    : d_category(&category), d_code(code), d_argc(sizeof...(Args)) {
+  static_assert(sizeof...(Args) <= kMaxArgs, "Too many error arguments");
+  static_assert((std::is_integral_v<Args> && ...),
+                "Error arguments must be integral");
+
+  std::size_t idx = 0;
+  ((d_args[idx++] = static_cast<std::int64_t>(args)), ...);
+}
@@ -0,0 +1,109 @@
+#include "../common/do_not_optimize.h"
+#include "../common/instrument.h"
+#include "error.h"
+#include "error_workloads.h"
+#include "expected.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Cost of the same fallible workload with Expected, exceptions and error
+// codes, swept over failure rate and call depth. Also reports binary sizes,
+// sizeof for common Expected instantiations and the copies/moves Expected
+// performs through transform chains. Output is a sequence of CSV tables,
+// each preceded by a "# name" line.
+
+constexpr int kIterations = 100000;
+
+// ============================================================== //
+// ========================== Timing ============================ //
+// ============================================================== //
+
+void report_timings() {
+  std::printf("# timing\n");
+  std::printf("depth,fail_percent,expected_ns,exception_ns,code_ns\n");
+
+  for (int depth : {1, 2, 4, 8, 16, 32}) {
+    for (int fail_percent : {0, 1, 5, 10, 25, 50}) {
+      auto inputs = make_inputs(kIterations, fail_percent);
+      std::printf("%d,%d,%.2f,%.2f,%.2f\n", depth, fail_percent,
+                  ns_per_op(inputs, depth, run_expected),
+                  ns_per_op(inputs, depth, run_exception),
+                  ns_per_op(inputs, depth, run_code));
+    }
+  }
+}
+
+// ============================================================== //
+// ======================= Binary size ========================== //
+// ============================================================== //
+
+void report_binary_sizes() {
+  std::printf("# binary_size\n");
+  std::printf("strategy,bytes\n");
+  std::printf("expected,%ju\n",
+              std::uintmax_t(std::filesystem::file_size(ERROR_SIZE_EXPECTED)));
+  std::printf("exception,%ju\n",
+              std::uintmax_t(std::filesystem::file_size(ERROR_SIZE_EXCEPTION)));
+  std::printf("code,%ju\n",
+              std::uintmax_t(std::filesystem::file_size(ERROR_SIZE_CODE)));
+}
+
+// ============================================================== //
+// ======================== Footprint =========================== //
+// ============================================================== //
+
+void report_sizeof() {
+  std::printf("# sizeof\n");
+  std::printf("type,bytes\n");
+  std::printf("Expected<int, ErrCode>,%zu\n", sizeof(Expected<int, ErrCode>));
+  std::printf("Expected<double, Error>,%zu\n", sizeof(Expected<double, Error>));
+  std::printf("Expected<std::string, Error>,%zu\n",
+              sizeof(Expected<std::string, Error>));
+}
+
+void report_copies(const char *name, int stages, const CountedScope &scope) {
+  std::printf("%s,%d,%zu,%zu\n", name, stages, scope.copies(), scope.moves());
+}
+
+void report_transform_copies() {
+  std::printf("# transform_copies\n");
+  std::printf("chain,stages,copies,moves\n");
+
+  auto step = [](const Counted &c) { return Counted(c.value() + 1); };
+  auto to_code = [](ErrCode e) { return int(e); };
+
+  Expected<Counted, ErrCode> success(Counted(1));
+  Expected<Counted, ErrCode> failure(ErrCode::Invalid);
+
+  CountedScope one_scope;
+  auto one = success.transform(step);
+  report_copies("transform_value", 1, one_scope);
+
+  CountedScope three_scope;
+  auto three = success.transform(step).transform(step).transform(step);
+  report_copies("transform_value", 3, three_scope);
+
+  CountedScope error_scope;
+  auto error = failure.transform(step).transform(step).transform(step);
+  report_copies("transform_error_path", 3, error_scope);
+
+  CountedScope mapped_scope;
+  auto mapped = success.transform_error(to_code);
+  report_copies("transform_error_value_path", 1, mapped_scope);
+
+  do_not_optimize(one);
+  do_not_optimize(three);
+  do_not_optimize(error);
+  do_not_optimize(mapped);
+}
+
+int main() {
+  report_timings();
+  report_binary_sizes();
+  report_sizeof();
+  report_transform_copies();
+  return 0;
+}
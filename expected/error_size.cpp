@@ -0,0 +1,18 @@
+#include "error_workloads.h"
+#include <cstdlib>
+
+// Minimal program built once per error handling strategy, so error_bench can
+// compare the size of the resulting binaries.
+
+int main(int argc, char **argv) {
+  int input = argc > 1 ? std::atoi(argv[1]) : 0;
+  int depth = argc > 2 ? std::atoi(argv[2]) : 8;
+
+#if ERROR_STRATEGY == 1
+  return run_expected(input, depth) < 0;
+#elif ERROR_STRATEGY == 2
+  return run_exception(input, depth) < 0;
+#else
+  return run_code(input, depth) < 0;
+#endif
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../common/do_not_optimize.h"
+#include "expected.h"
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+// The same fallible call chain written three ways, plus the input generator
+// and timing loop shared by error_bench and coroutine_bench. The leaf fails for
+// negative inputs and every other frame adds one to the result. Frames are
+// kept out of line so `depth` is the number of real calls on the stack.
+
+enum class ErrCode { Ok, Invalid };
+
+[[gnu::noinline]] inline Expected<int, ErrCode> expected_chain(int input,
+                                                              int depth) {
+  if (depth == 0) {
+    if (input < 0) {
+      return ErrCode::Invalid;
+    }
+    return input;
+  }
+  auto res = expected_chain(input, depth - 1);
+  if (!res) {
+    return res.error();
+  }
+  return res.value() + 1;
+}
+
+[[gnu::noinline]] inline int exception_chain(int input, int depth) {
+  if (depth == 0) {
+    if (input < 0) {
+      throw std::invalid_argument("negative input");
+    }
+    return input;
+  }
+  // Without the barrier GCC folds the recursion into `input + depth`,
+  // leaving no frames to unwind.
+  int res = exception_chain(input, depth - 1);
+  do_not_optimize(res);
+  return res + 1;
+}
+
+[[gnu::noinline]] inline ErrCode code_chain(int input, int depth, int &out) {
+  if (depth == 0) {
+    if (input < 0) {
+      return ErrCode::Invalid;
+    }
+    out = input;
+    return ErrCode::Ok;
+  }
+  ErrCode code = code_chain(input, depth - 1, out);
+  if (code != ErrCode::Ok) {
+    return code;
+  }
+  out += 1;
+  return ErrCode::Ok;
+}
+
+inline int run_expected(int input, int depth) {
+  return expected_chain(input, depth).value_or(-1);
+}
+
+inline int run_exception(int input, int depth) {
+  try {
+    return exception_chain(input, depth);
+  } catch (const std::exception &) {
+    return -1;
+  }
+}
+
+inline int run_code(int input, int depth) {
+  int out = 0;
+  if (code_chain(input, depth, out) != ErrCode::Ok) {
+    return -1;
+  }
+  return out;
+}
+
+// ============================================================== //
+// ========================== Harness =========================== //
+// ============================================================== //
+
+// `count` inputs of which roughly `fail_percent` percent are negative,
+// spread evenly so failures do not come in runs.
+inline std::vector<int> make_inputs(int count, int fail_percent) {
+  std::vector<int> inputs(count);
+  for (int i = 0; i < count; ++i) {
+    inputs[i] = (i * 37 % 100) < fail_percent ? -1 : i;
+  }
+  return inputs;
+}
+
+// Average nanoseconds per `fn(input, depth)` call over `inputs`.
+template <typename F>
+double ns_per_op(const std::vector<int> &inputs, int depth, F fn) {
+  auto start = std::chrono::steady_clock::now();
+  for (int input : inputs) {
+    do_not_optimize(fn(input, depth));
+  }
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() /
+         inputs.size();
+}
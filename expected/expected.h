@@ -1,12 +1,20 @@
+#pragma once
+
+#include <coroutine>
 #include <functional>
 #include <iostream>
 #include <optional>
 
 template <typename T, typename E> class Expected {
 public:
+  class promise_type;
+  class ReturnSlot;
+  class Awaiter;
+
   Expected() : d_val(std::nullopt), d_unexpected(std::nullopt) {}
   Expected(T value) : d_val(std::move(value)), d_unexpected(std::nullopt) {}
   Expected(E error) : d_val(std::nullopt), d_unexpected(std::move(error)) {}
+  Expected(ReturnSlot &&slot);
 
   const T &value() const;
   const T &value_or(const T &or_value) const;
@@ -30,11 +38,89 @@ public:
   template <typename F> auto transform(F &&fn) const;
   template <typename F> auto transform_error(F &&fn) const;
 
+  Awaiter operator co_await() const { return Awaiter(*this); }
+
 private:
   std::optional<T> d_val;
   std::optional<E> d_unexpected;
 };
 
+// ============================================================== //
+// ======================== Coroutines ========================== //
+// ============================================================== //
+
+// Expected can be used as a coroutine return type. `co_await` on an Expected
+// yields its value or stops the coroutine, returning the error to the caller.
+// The coroutine never suspends, so its frame does not outlive the call and
+// compilers that support allocation elision can place it on the stack.
+
+template <typename T, typename E> class Expected<T, E>::promise_type {
+  friend ReturnSlot;
+  friend Expected;
+
+private:
+  Expected *d_result = nullptr;
+
+public:
+  ReturnSlot get_return_object() { return ReturnSlot(*this); }
+
+  std::suspend_never initial_suspend() noexcept { return {}; }
+  std::suspend_never final_suspend() noexcept { return {}; }
+
+  void return_value(Expected result) { *d_result = std::move(result); }
+  void unhandled_exception() { throw; }
+};
+
+// Compilers differ on whether the result of get_return_object() is converted
+// to Expected before or after the coroutine body runs. The slot holds the
+// result for the late case, and hands the promise over to the Expected being
+// constructed in the early case.
+template <typename T, typename E> class Expected<T, E>::ReturnSlot {
+  friend Expected;
+  friend promise_type;
+
+private:
+  Expected d_storage;
+  promise_type *d_promise;
+
+  explicit ReturnSlot(promise_type &promise) : d_promise(&promise) {
+    d_promise->d_result = &d_storage;
+  }
+
+public:
+  ReturnSlot(ReturnSlot &&o) : d_promise(o.d_promise) {
+    d_promise->d_result = &d_storage;
+  }
+};
+
+template <typename T, typename E> class Expected<T, E>::Awaiter {
+private:
+  const Expected &d_expected;
+
+public:
+  explicit Awaiter(const Expected &expected) : d_expected(expected) {}
+
+  bool await_ready() const { return d_expected.has_value(); }
+
+  template <typename P> void await_suspend(std::coroutine_handle<P> handle) {
+    handle.promise().return_value(d_expected.error());
+    handle.destroy();
+  }
+
+  T await_resume() const { return d_expected.value(); }
+};
+
+template <typename T, typename E>
+Expected<T, E>::Expected(ReturnSlot &&slot)
+    : d_val(std::nullopt), d_unexpected(std::nullopt) {
+  if (slot.d_storage.d_val || slot.d_storage.d_unexpected) {
+    d_val = std::move(slot.d_storage.d_val);
+    d_unexpected = std::move(slot.d_storage.d_unexpected);
+  } else {
+    slot.d_promise->d_result = this;
+  }
+}
+
 template <typename T, typename E> const T *Expected<T, E>::operator->() const {
   return &value();
 }
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "expected.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ============================================================== //
+// ======================= ExpectedArray ======================== //
+// ============================================================== //
+
+// Structure-of-arrays batch of `Expected<T, E>`. Values live in one
+// contiguous array, a bitmask marks the lanes holding a value and errors are
+// kept in a side table sorted by lane index. Error lanes hold a
+// value-initialized T, so T must be default constructible. The array is a
+// plain `T[]` rather than a std::vector so that `values()` also works for
+// bool, e.g. for the result of a predicate transform.
+//
+// `transform` runs over every lane without branching on the mask so the loop
+// can be vectorized. Precondition: the function is total over T, error lanes
+// pass it a value-initialized T and its results for them are discarded.
+// Functions that are not, e.g. `100 / x` for integral T, must use
+// `transform_masked`, which only calls the function on valid lanes and
+// value-initializes the result of error lanes.
+template <typename T, typename E> class ExpectedArray {
+  template <typename, typename> friend class ExpectedArray;
+
+public:
+  ExpectedArray() = default;
+  ExpectedArray(const ExpectedArray &other);
+  ExpectedArray(ExpectedArray &&other) noexcept;
+  ExpectedArray &operator=(ExpectedArray other) noexcept;
+
+  std::size_t size() const { return d_size; }
+  bool empty() const { return d_size == 0; }
+  void reserve(std::size_t count);
+  void clear();
+
+  void push_back(T value);
+  void push_back(const Expected<T, E> &expected);
+  void push_back_error(E error);
+
+  bool has_value(std::size_t idx) const;
+  const T &value(std::size_t idx) const { return d_values[idx]; }
+  const E &error(std::size_t idx) const;
+  Expected<T, E> operator[](std::size_t idx) const;
+
+  const T *values() const { return d_values.get(); }
+
+  template <typename F> auto transform(F &&fn) const;
+  template <typename F> auto transform_masked(F &&fn) const;
+  template <typename F> auto transform_error(F &&fn) const;
+
+  std::size_t count_errors() const { return d_errors.size(); }
+  std::optional<std::size_t> first_error() const;
+
+private:
+  static constexpr std::size_t kBits = 64;
+
+  void grow(std::size_t capacity);
+  T &next_lane();
+  void push_lane(bool valid);
+
+  std::unique_ptr<T[]> d_values;
+  std::size_t d_size = 0;
+  std::size_t d_capacity = 0;
+  std::vector<std::uint64_t> d_valid;
+  std::vector<std::pair<std::size_t, E>> d_errors;
+};
+
+template <typename T, typename E>
+ExpectedArray<T, E>::ExpectedArray(const ExpectedArray &other)
+    : d_values(std::make_unique<T[]>(other.d_size)), d_size(other.d_size),
+      d_capacity(other.d_size), d_valid(other.d_valid),
+      d_errors(other.d_errors) {
+  std::copy_n(other.d_values.get(), d_size, d_values.get());
+}
+
+template <typename T, typename E>
+ExpectedArray<T, E>::ExpectedArray(ExpectedArray &&other) noexcept
+    : d_values(std::move(other.d_values)),
+      d_size(std::exchange(other.d_size, 0)),
+      d_capacity(std::exchange(other.d_capacity, 0)),
+      d_valid(std::move(other.d_valid)), d_errors(std::move(other.d_errors)) {}
+
+template <typename T, typename E>
+ExpectedArray<T, E> &
+ExpectedArray<T, E>::operator=(ExpectedArray other) noexcept {
+  std::swap(d_values, other.d_values);
+  std::swap(d_size, other.d_size);
+  std::swap(d_capacity, other.d_capacity);
+  std::swap(d_valid, other.d_valid);
+  std::swap(d_errors, other.d_errors);
+  return *this;
+}
+
+template <typename T, typename E>
+void ExpectedArray<T, E>::reserve(std::size_t count) {
+  if (count > d_capacity) {
+    grow(count);
+  }
+  d_valid.reserve((count + kBits - 1) / kBits);
+}
+
+// Lanes past the size are kept value-initialized, so clear() resets the ones
+// in use and push_back_error() can take the next slot as is.
+template <typename T, typename E> void ExpectedArray<T, E>::clear() {
+  std::fill_n(d_values.get(), d_size, T());
+  d_size = 0;
+  d_valid.clear();
+  d_errors.clear();
+}
+
+template <typename T, typename E>
+void ExpectedArray<T, E>::grow(std::size_t capacity) {
+  auto values = std::make_unique<T[]>(capacity);
+  for (std::size_t i = 0; i < d_size; ++i) {
+    values[i] = std::move_if_noexcept(d_values[i]);
+  }
+  d_values = std::move(values);
+  d_capacity = capacity;
+}
+
+template <typename T, typename E> T &ExpectedArray<T, E>::next_lane() {
+  if (d_size == d_capacity) {
+    grow(std::max<std::size_t>(2 * d_capacity, 16));
+  }
+  return d_values[d_size];
+}
+
+template <typename T, typename E>
+void ExpectedArray<T, E>::push_lane(bool valid) {
+  std::size_t idx = d_size++;
+  if (idx % kBits == 0) {
+    d_valid.push_back(0);
+  }
+  if (valid) {
+    d_valid.back() |= std::uint64_t(1) << (idx % kBits);
+  }
+}
+
+template <typename T, typename E> void ExpectedArray<T, E>::push_back(T value) {
+  next_lane() = std::move(value);
+  push_lane(true);
+}
+
+template <typename T, typename E>
+void ExpectedArray<T, E>::push_back(const Expected<T, E> &expected) {
+  if (expected) {
+    push_back(expected.value());
+  } else {
+    push_back_error(expected.error());
+  }
+}
+
+template <typename T, typename E>
+void ExpectedArray<T, E>::push_back_error(E error) {
+  next_lane();
+  push_lane(false);
+  d_errors.emplace_back(d_size - 1, std::move(error));
+}
+
+template <typename T, typename E>
+bool ExpectedArray<T, E>::has_value(std::size_t idx) const {
+  return (d_valid[idx / kBits] >> (idx % kBits)) & 1;
+}
+
+template <typename T, typename E>
+const E &ExpectedArray<T, E>::error(std::size_t idx) const {
+  assert(!has_value(idx) && "error() called on a valid lane");
+  auto it = std::lower_bound(
+      d_errors.begin(), d_errors.end(), idx,
+      [](const std::pair<std::size_t, E> &entry, std::size_t key) {
+        return entry.first < key;
+      });
+  return it->second;
+}
+
+template <typename T, typename E>
+Expected<T, E> ExpectedArray<T, E>::operator[](std::size_t idx) const {
+  if (has_value(idx)) {
+    return Expected<T, E>(d_values[idx]);
+  }
+  return Expected<T, E>(error(idx));
+}
+
+template <typename T, typename E>
+template <typename F>
+auto ExpectedArray<T, E>::transform(F &&fn) const {
+  using R = std::remove_cvref_t<std::invoke_result_t<F &, const T &>>;
+  ExpectedArray<R, E> res;
+
+  // Every lane is written below, so the result needs no initialization.
+  const std::size_t count = d_size;
+  res.d_values = std::make_unique_for_overwrite<R[]>(count);
+  res.d_size = res.d_capacity = count;
+
+  const T *in = d_values.get();
+  R *out = res.d_values.get();
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = std::invoke(fn, in[i]);
+  }
+
+  res.d_valid = d_valid;
+  res.d_errors = d_errors;
+  return res;
+}
+
+// Walks the mask a word at a time: fully valid words get the same dense loop
+// as transform, mixed words visit their set bits only.
+template <typename T, typename E>
+template <typename F>
+auto ExpectedArray<T, E>::transform_masked(F &&fn) const {
+  using R = std::remove_cvref_t<std::invoke_result_t<F &, const T &>>;
+  ExpectedArray<R, E> res;
+  res.grow(d_size);
+  res.d_size = d_size;
+
+  const T *in = d_values.get();
+  R *out = res.d_values.get();
+  for (std::size_t word = 0; word < d_valid.size(); ++word) {
+    const std::size_t base = word * kBits;
+    std::uint64_t mask = d_valid[word];
+    if (~mask == 0) {
+      for (std::size_t i = base; i < base + kBits; ++i) {
+        out[i] = std::invoke(fn, in[i]);
+      }
+      continue;
+    }
+    while (mask != 0) {
+      std::size_t i = base + std::countr_zero(mask);
+      out[i] = std::invoke(fn, in[i]);
+      mask &= mask - 1;
+    }
+  }
+
+  res.d_valid = d_valid;
+  res.d_errors = d_errors;
+  return res;
+}
+
+template <typename T, typename E>
+template <typename F>
+auto ExpectedArray<T, E>::transform_error(F &&fn) const {
+  using R = std::remove_cvref_t<std::invoke_result_t<F &, const E &>>;
+  ExpectedArray<T, R> res;
+  res.grow(d_size);
+  res.d_size = d_size;
+  std::copy_n(d_values.get(), d_size, res.d_values.get());
+
+  res.d_valid = d_valid;
+  res.d_errors.reserve(d_errors.size());
+  for (const auto &[idx, error] : d_errors) {
+    res.d_errors.emplace_back(idx, std::invoke(fn, error));
+  }
+  return res;
+}
+
+template <typename T, typename E>
+std::optional<std::size_t> ExpectedArray<T, E>::first_error() const {
+  if (d_errors.empty()) {
+    return std::nullopt;
+  }
+  return d_errors.front().first;
+}
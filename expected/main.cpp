@@ -1,7 +1,13 @@
+#include "error.h"
 #include "expected.h"
+#include "expected_array.h"
+#include "parallel.h"
+#include <atomic>
 #include <cassert>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
 void test_construction() {
   std::cout << "Testing construction..." << std::endl;
@@ -163,6 +169,261 @@ void test_dereference_operators() {
   assert(*num_success == 123);
 }
 
+class ValidationCategory : public ErrorCategory {
+public:
+  enum Code { OutOfRange = 1, TooLong = 2, Unknown = 3 };
+
+  const char *name() const override { return "validation"; }
+
+  const char *format(int code) const override {
+    switch (code) {
+    case OutOfRange:
+      return "value {} outside [{}, {}]";
+    case TooLong:
+      return "length {} exceeds {}";
+    default:
+      return nullptr;
+    }
+  }
+};
+
+const ValidationCategory validation_category;
+
+void test_error_payload() {
+  std::cout << "Testing Error payload..." << std::endl;
+
+  Error range(ValidationCategory::OutOfRange, validation_category, 12, 0, 10);
+  assert(range.code() == ValidationCategory::OutOfRange);
+  assert(&range.category() == &validation_category);
+  assert(range.arg_count() == 3);
+  assert(range.arg(0) == 12);
+  assert(range.message() == "value 12 outside [0, 10]");
+
+  Error unknown(ValidationCategory::Unknown, validation_category);
+  assert(unknown.message() == "validation:3");
+
+  Error too_long(ValidationCategory::TooLong, validation_category, 300, 255);
+  assert(too_long == Error(ValidationCategory::TooLong, validation_category,
+                           300, 255));
+  assert(too_long != Error(ValidationCategory::TooLong, validation_category,
+                           301, 255));
+
+  Expected<int, Error> failure(range);
+  assert(!failure.has_value());
+  assert(failure.error() == range);
+
+  auto halved = failure.transform([](int a) { return a / 2; });
+  assert(!halved.has_value());
+  assert(halved.error().message() == "value 12 outside [0, 10]");
+
+  Expected<int, Error> success(7);
+  assert(success.transform([](int a) { return a * 2; }).value() == 14);
+}
+
+Expected<int, std::string> parse_digit(char c) {
+  if (c < '0' || c > '9') {
+    return std::string("not a digit: ") + c;
+  }
+  return c - '0';
+}
+
+Expected<int, std::string> parse_number(const std::string &str) {
+  int result = 0;
+  for (char c : str) {
+    int digit = co_await parse_digit(c);
+    result = result * 10 + digit;
+  }
+  co_return result;
+}
+
+Expected<int, std::string> sum_numbers(const std::string &a,
+                                       const std::string &b) {
+  int lhs = co_await parse_number(a);
+  int rhs = co_await parse_number(b);
+  co_return lhs + rhs;
+}
+
+void test_coroutine() {
+  std::cout << "Testing coroutine propagation..." << std::endl;
+
+  auto number = parse_number("1234");
+  assert(number.has_value());
+  assert(number.value() == 1234);
+
+  auto bad_number = parse_number("12x4");
+  assert(!bad_number.has_value());
+  assert(bad_number.error() == "not a digit: x");
+
+  auto sum = sum_numbers("40", "2");
+  assert(sum.has_value());
+  assert(sum.value() == 42);
+
+  auto bad_sum = sum_numbers("40", "?");
+  assert(!bad_sum.has_value());
+  assert(bad_sum.error() == "not a digit: ?");
+}
+
+void test_expected_array() {
+  std::cout << "Testing ExpectedArray..." << std::endl;
+
+  enum class ErrCode { Negative, TooLarge };
+
+  ExpectedArray<double, ErrCode> batch;
+  assert(batch.empty());
+  assert(!batch.first_error().has_value());
+
+  for (int i = 0; i < 130; ++i) {
+    if (i == 70) {
+      batch.push_back_error(ErrCode::Negative);
+    } else if (i == 100) {
+      batch.push_back(Expected<double, ErrCode>(ErrCode::TooLarge));
+    } else {
+      batch.push_back(i * 1.5);
+    }
+  }
+
+  assert(batch.size() == 130);
+  assert(batch.count_errors() == 2);
+  assert(batch.first_error().value() == 70);
+  assert(batch.has_value(69));
+  assert(!batch.has_value(70));
+  assert(!batch.has_value(100));
+  assert(batch.has_value(129));
+  assert(batch.error(100) == ErrCode::TooLarge);
+  assert(batch[3].value() == 4.5);
+  assert(batch[70].error() == ErrCode::Negative);
+
+  auto doubled = batch.transform([](double v) { return v * 2; });
+  assert(doubled.size() == 130);
+  assert(doubled.count_errors() == 2);
+  assert(doubled.value(3) == 9.0);
+  assert(doubled.value(129) == 387.0);
+  assert(doubled.error(70) == ErrCode::Negative);
+
+  // Integer division traps on the zeroed error lanes, only the masked
+  // variant may call it.
+  ExpectedArray<int, ErrCode> divisors;
+  for (int i = 1; i <= 200; ++i) {
+    if (i % 3 == 0) {
+      divisors.push_back_error(ErrCode::Negative);
+    } else {
+      divisors.push_back(i);
+    }
+  }
+  auto quotients = divisors.transform_masked([](int x) { return 600 / x; });
+  assert(quotients.size() == 200);
+  assert(quotients.count_errors() == divisors.count_errors());
+  assert(quotients.value(0) == 600);
+  assert(quotients.value(199) == 3);
+  assert(!quotients.has_value(2));
+  assert(quotients.value(2) == 0);
+
+  auto masked = batch.transform_masked([](double v) { return v * 2; });
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    assert(masked[i] == doubled[i]);
+  }
+
+  auto as_int = batch.transform_error([](ErrCode e) { return int(e) + 1; });
+  assert(as_int.value(3) == 4.5);
+  assert(as_int.error(70) == 1);
+  assert(as_int.error(100) == 2);
+  assert(as_int[100] == (Expected<double, int>(2)));
+
+  auto positive = batch.transform([](double v) { return v > 0; });
+  const bool *flags = positive.values();
+  assert(!flags[0] && flags[1] && flags[129]);
+  assert(positive.error(70) == ErrCode::Negative);
+
+  // Copies are independent, moves leave the source empty and clear() keeps
+  // error lanes value-initialized.
+  ExpectedArray<double, ErrCode> copy = batch;
+  ExpectedArray<double, ErrCode> moved = std::move(copy);
+  assert(copy.empty());
+  assert(moved.size() == 130 && moved.value(3) == 4.5);
+  moved.clear();
+  moved.push_back(2.5);
+  moved.push_back_error(ErrCode::TooLarge);
+  assert(moved.value(0) == 2.5 && moved.value(1) == 0.0);
+  assert(batch.value(0) == 0.0 && batch.value(3) == 4.5);
+}
+
+void test_try_transform() {
+  std::cout << "Testing parallel try_transform()..." << std::endl;
+
+  std::vector<int> inputs(100000);
+  for (int i = 0; i < int(inputs.size()); ++i) {
+    inputs[i] = i;
+  }
+
+  auto square = [](int a) -> Expected<long long, std::string> {
+    return (long long)a * a;
+  };
+  auto all = try_transform(inputs, square, 4);
+  assert(all.has_value());
+  assert(all.value().size() == inputs.size());
+  assert(all.value()[99999] == 99999LL * 99999LL);
+
+  auto reject = [](int a) -> Expected<int, std::string> {
+    if (a == 50000 || a == 70000) {
+      return "rejected " + std::to_string(a);
+    }
+    return a;
+  };
+  auto failed = try_transform(inputs, reject, 4);
+  assert(!failed.has_value());
+  assert(failed.error() == "rejected 50000");
+
+  std::atomic<int> calls = 0;
+  auto fail_first = [&calls](int a) -> Expected<int, std::string> {
+    ++calls;
+    if (a == 0) {
+      return std::string("first");
+    }
+    return a;
+  };
+  auto cancelled = try_transform(inputs, fail_first, 4);
+  assert(cancelled.error() == "first");
+  assert(calls < int(inputs.size()) / 2);
+
+  // Neighbouring bool results are written by different threads.
+  auto even = [](int a) -> Expected<bool, std::string> { return a % 2 == 0; };
+  auto flags = try_transform(inputs, even, 4, 1);
+  assert(flags.has_value());
+  for (int i = 0; i < int(inputs.size()); ++i) {
+    assert(flags.value()[i] == (i % 2 == 0));
+  }
+
+  // The lowest failing input wins whether it failed with an error or an
+  // exception, even when the exception is thrown first.
+  std::atomic<bool> threw = false;
+  auto mixed = [&threw](int a) -> Expected<int, std::string> {
+    if (a == 10) {
+      while (!threw) {
+        std::this_thread::yield();
+      }
+      return std::string("rejected");
+    }
+    if (a == 5000) {
+      threw = true;
+      throw std::runtime_error("thrown");
+    }
+    return a;
+  };
+  assert(try_transform(inputs, mixed, 4).error() == "rejected");
+
+  bool thrown = false;
+  try {
+    std::vector<int> tail(inputs.begin() + 20, inputs.end());
+    try_transform(tail, mixed, 4);
+  } catch (const std::runtime_error &) {
+    thrown = true;
+  }
+  assert(thrown);
+
+  std::vector<int> none;
+  assert(try_transform(none, square, 4).value().empty());
+}
+
 int main() {
   try {
     test_construction();
@@ -174,6 +435,10 @@ int main() {
     test_transform();
     test_transform_error();
     test_dereference_operators();
+    test_error_payload();
+    test_coroutine();
+    test_expected_array();
+    test_try_transform();
 
     std::cout << "All tests passed successfully!" << std::endl;
   } catch (const std::exception &e) {
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "expected.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+template <typename> struct ExpectedTraits;
+
+template <typename T, typename E> struct ExpectedTraits<Expected<T, E>> {
+  using value_type = T;
+  using error_type = E;
+};
+
+// ============================================================== //
+// ======================= try_transform ======================== //
+// ============================================================== //
+
+// Applies `fn` to every input on `threads` threads and returns either all
+// results or the failure of the lowest failing input, matching what a serial
+// loop would return. A failure is an error result or an exception thrown by
+// `fn`, the latter is rethrown. Inputs are handed out in chunks in increasing
+// order, so once an input fails, chunks after it are skipped and workers stop
+// early. `fn` must return `Expected<R, E>` with a default constructible R.
+template <typename T, typename F>
+auto try_transform(const std::vector<T> &inputs, F &&fn,
+                   std::size_t threads = std::thread::hardware_concurrency(),
+                   std::size_t chunk_size = 256) {
+  using Result = std::remove_cvref_t<std::invoke_result_t<F &, const T &>>;
+  using R = typename ExpectedTraits<Result>::value_type;
+  using E = typename ExpectedTraits<Result>::error_type;
+
+  const std::size_t count = inputs.size();
+  chunk_size = std::max<std::size_t>(chunk_size, 1);
+
+  // vector<bool> packs elements into shared words, so bool results are
+  // written to one byte each and packed after the workers are done.
+  using Slot = std::conditional_t<std::is_same_v<R, bool>, unsigned char, R>;
+  std::vector<Slot> results(count);
+  std::atomic<std::size_t> next_chunk{0};
+  std::atomic<std::size_t> failed_at{count};
+  std::optional<E> error;
+  std::exception_ptr exception;
+  std::mutex mutex;
+
+  auto worker = [&] {
+    std::size_t i = count;
+    try {
+      while (true) {
+        std::size_t begin = next_chunk.fetch_add(chunk_size);
+        if (begin >= std::min(count, failed_at.load())) {
+          return;
+        }
+
+        std::size_t end = std::min(begin + chunk_size, count);
+        for (i = begin; i < end; ++i) {
+          if (i > failed_at.load(std::memory_order_relaxed)) {
+            return;
+          }
+
+          Result res = std::invoke(fn, inputs[i]);
+          if (!res) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (i < failed_at.load()) {
+              failed_at.store(i);
+              error = res.error();
+              exception = nullptr;
+            }
+            return;
+          }
+          results[i] = res.value();
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (i < failed_at.load()) {
+        failed_at.store(i);
+        error.reset();
+        exception = std::current_exception();
+      }
+    }
+  };
+
+  const std::size_t chunks = (count + chunk_size - 1) / chunk_size;
+  const std::size_t workers =
+      std::min(std::max<std::size_t>(threads, 1), chunks);
+  {
+    std::vector<std::jthread> pool;
+    for (std::size_t i = 1; i < workers; ++i) {
+      pool.emplace_back(worker);
+    }
+    worker();
+  }
+
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+  if (error) {
+    return Expected<std::vector<R>, E>(std::move(*error));
+  }
+  if constexpr (std::is_same_v<R, bool>) {
+    return Expected<std::vector<R>, E>(
+        std::vector<R>(results.begin(), results.end()));
+  } else {
+    return Expected<std::vector<R>, E>(std::move(results));
+  }
+}
@@ -1,21 +1,44 @@
+#pragma once
+
+#include "../common/list_error.h"
+#include "../common/node_block.h"
+#include "../expected/expected.h"
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <ostream>
+#include <ranges>
+#include <utility>
 
 using namespace std;
 
 template <typename T>
 class LinkedList {
 private:
+  struct Node;
+
+  // Nodes either come from plain new or from a NodeBlock.
+  struct NodeDeleter {
+    void operator()(Node* node) const {
+      NodeBlock<Node>::destroy(node);
+    }
+  };
+  using NodePtr = unique_ptr<Node, NodeDeleter>;
+
   struct Node {
     template<typename C = T>
-    Node(C&& val, unique_ptr<Node> nextNode) 
+    Node(C&& val, NodePtr nextNode) 
     : d_val(forward<C>(val))
     , next(move(nextNode))
     {};
 
     T                 d_val;
-    unique_ptr<Node>  next;
+    // For T smaller than a pointer this fits in the padding before next.
+    bool              d_pooled = false;
+    NodePtr           next;
 
     const T& val() const {
       return d_val;
@@ -24,21 +47,134 @@ private:
     T& val() {
       return d_val;
     }
+
+    bool& pooled() {
+      return d_pooled;
+    }
   };
 
-  unique_ptr<Node> root;
+  NodePtr root;
   Node* head = nullptr;
+
+  // Unlink nodes one at a time, letting the unique_ptr chain destroy itself
+  // recursively overflows the stack on long lists.
+  static void destroy_chain(NodePtr& node) {
+    while (node != nullptr) {
+      node = move(node->next);
+    }
+  }
+
+  // Builds `count` nodes in one NodeBlock from successive `next()` results
+  // and links them after head. Ownership only moves into the NodePtr chain
+  // once the whole block is built.
+  template<typename F>
+  void append_block(size_t count, F next) {
+    auto [first, last] = NodeBlock<Node>::build(
+        count,
+        [&next](NodeBlock<Node>& block, size_t idx) {
+          block.construct(idx, next(), nullptr);
+        },
+        [](Node* prev, Node* node) { prev->next.reset(node); });
+    if (first == nullptr) {
+      return;
+    }
+
+    if (root == nullptr) {
+      root.reset(first);
+    } else {
+      head->next.reset(first);
+    }
+    head = last;
+  }
+
 public:
+  // Copies and the bulk operations below take their nodes from a single
+  // NodeBlock, see node_block.h for when that memory is given back.
+  // push_back allocates one node at a time.
+  LinkedList() = default;
+
+  LinkedList(const LinkedList& o) {
+    size_t count = 0;
+    for (const Node* node = o.root.get(); node; node = node->next.get()) {
+      ++count;
+    }
+
+    const Node* node = o.root.get();
+    append_block(count, [&node]() -> const T& {
+      const T& val = node->val();
+      node = node->next.get();
+      return val;
+    });
+  }
+
+  LinkedList(LinkedList&& o) noexcept
+  : root(move(o.root))
+  , head(exchange(o.head, nullptr))
+  {};
+
+  // Delegating means a throw from append() runs ~LinkedList, which unlinks
+  // the partial list iteratively instead of letting root recurse into it.
+  template<input_iterator It>
+  LinkedList(It first, It last) : LinkedList() {
+    append(first, last);
+  }
+
+  LinkedList(initializer_list<T> values) : LinkedList() {
+    append(values.begin(), values.end());
+  }
+
+  ~LinkedList() {
+    clear();
+  }
+
+  LinkedList& operator=(LinkedList o) noexcept {
+    swap(o);
+    return *this;
+  }
+
+  void swap(LinkedList& o) noexcept {
+    std::swap(root, o.root);
+    std::swap(head, o.head);
+  }
+
+  template<input_iterator It>
+  void assign(It first, It last) {
+    LinkedList tmp(first, last);
+    swap(tmp);
+  }
+
+  void assign(initializer_list<T> values) {
+    assign(values.begin(), values.end());
+  }
+
+  template<ranges::input_range R>
+  void append_range(R&& range) {
+    append(ranges::begin(range), ranges::end(range));
+  }
+
+  // A single-pass range can't be measured before it is read, so it is
+  // appended node by node.
+  template<input_iterator It>
+  void append(It first, It last) {
+    if constexpr (forward_iterator<It>) {
+      append_block(distance(first, last),
+                   [&first]() -> decltype(auto) { return *first++; });
+    } else {
+      for (; first != last; ++first) {
+        push_back(*first);
+      }
+    }
+  }
   
 
   template<typename C = T>
   void push_back(C&& val) {
     if (root == nullptr) {
-      root = make_unique<Node>(forward<C>(val), nullptr);
+      root = NodePtr(new Node(forward<C>(val), nullptr));
       head = root.get();
       return;
     }
-    head->next = make_unique<Node>(forward<C>(val), nullptr);
+    head->next = NodePtr(new Node(forward<C>(val), nullptr));
     head = head->next.get();
   } 
 
@@ -54,8 +190,9 @@ public:
       throw std::runtime_error("Cannot pop_back() on empty list");
     } 
     else if (root->next == nullptr) {
-      C tmp = root->val();
+      C tmp = move(root->val());
       root = nullptr;
+      head = nullptr;
       return tmp;
     }
 
@@ -68,7 +205,7 @@ public:
       curr = curr->next.get();
     }
 
-    const C tmp = curr->val();
+    C tmp = move(curr->val());
     tail->next = nullptr;
     head = tail;
     return tmp;
@@ -80,21 +217,44 @@ public:
     if (root == nullptr) 
       throw std::runtime_error("Cannot pop_front() on empty list");
    
-    const C tmp = root->val();
+    C tmp = move(root->val());
     root = move(root->next);
+    if (root == nullptr) {
+      head = nullptr;
+    }
     return tmp;
   }
 
+  Expected<T, ListError> try_pop_back() {
+    if (root == nullptr) {
+      return ListError::Empty;
+    }
+    return pop_back();
+  }
+
+  Expected<T, ListError> try_pop_front() {
+    if (root == nullptr) {
+      return ListError::Empty;
+    }
+    return pop_front();
+  }
+
   struct Iterator {
     friend LinkedList;
   private:
     Node* nodePtr = nullptr;
 
   public:
+    using iterator_category = forward_iterator_tag;
+    using value_type        = T;
+    using difference_type   = ptrdiff_t;
+    using pointer           = T*;
+    using reference         = T&;
+
+    Iterator() = default;
     Iterator(Node *node) : nodePtr(node) {};
-    Iterator(const Iterator& o) : nodePtr(o.nodePtr) {};
 
-    const Iterator& operator++() {
+    Iterator& operator++() {
       if (nodePtr == nullptr) {
         return *this;
       }
@@ -102,7 +262,7 @@ public:
       return *this;
     }
 
-    const Iterator operator++(int) {
+    Iterator operator++(int) {
       Iterator old = *this;
       operator++();
       return old;
@@ -115,10 +275,9 @@ public:
       return !(nodePtr == rhs.nodePtr); 
     }
 
-    template<typename C = T>
-    C& operator*() {
-      C& val = nodePtr->val();
-      return val;
+    // Constness of the iterator doesn't carry over to the element.
+    T& operator*() const {
+      return nodePtr->val();
     }
   };
 
@@ -138,14 +297,14 @@ public:
     int size = 0;
     Iterator it = begin();
     while (it != end()) {
-      +it;
+      ++it;
       ++size;
     }
     return size;
   }
 
   void clear() {
-    root = nullptr;
+    destroy_chain(root);
     head = nullptr;
   }
 
@@ -158,4 +317,18 @@ public:
   C& back() {
     return head->val();
   }
+
+  Expected<reference_wrapper<T>, ListError> try_front() {
+    if (root == nullptr) {
+      return ListError::Empty;
+    }
+    return ref(root->val());
+  }
+
+  Expected<reference_wrapper<T>, ListError> try_back() {
+    if (root == nullptr) {
+      return ListError::Empty;
+    }
+    return ref(head->val());
+  }
 };
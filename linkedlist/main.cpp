@@ -1,39 +1,27 @@
+#include "../common/instrument.h"
+#include "../common/list_tests.h"
 #include "linkedList.h"
+#include <cassert>
 #include <iostream>
+#include <vector>
 
-int TestNr = 0;
-
-class Test {
-public: 
-  Test(){
-    cout << "Constructed" << endl;
-  }
-
-  Test(const Test& o) {
-    cout << "Copied" << endl;
-  }
-
-  Test(Test&& o) {
-    cout << "Moved" << endl;
-  }
-
-  Test& operator=(const Test& o) {
-    cout << "Copy Assigned" << endl;
-    return *this;
-  }
-
-  Test& operator=(Test&& o) {
-    cout << "Move Assigned" << endl;
-    return *this;
-  }
-
-  ~Test(){
-    cout << "Destroyed" << endl;
-  }
-};
+// Bulk loads keep the tail pointer on the last node.
+void test_copy_tail() {
+  LinkedList<Counted> list = {0, 1, 2};
+  list.append_range(std::vector<int>({3}));
+  assert(list.try_back().value().get() == Counted(3));
 
+  assert(list.pop_back().value() == 3);
+  list.push_back(Counted(5));
+  assert(list.try_back().value().get() == Counted(5));
+  assert(list.size() == 4);
+}
 
 int main() {
+  test_list_instrumented<LinkedList>();
+  test_list_copy<LinkedList>();
+  test_copy_tail();
+
   LinkedList<int> list;
   int a = 10;
   int b = 12;
@@ -55,5 +43,22 @@ int main() {
   std::cout << "Size = " << list.size() << std::endl;
   std::cout << "Size = " << list.size() << std::endl;
 
+  assert(list.try_front().value() == 10);
+  assert(list.try_back().value() == 15);
+  assert(list.try_pop_back().value() == 15);
+  assert(list.try_back().value() == 13);
+
+  std::cout << "Draining" << std::endl;
+  while (auto val = list.try_pop_front()) {
+    std::cout << val.value() << std::endl;
+  }
+  assert(list.empty());
+  assert(list.try_back().error() == ListError::Empty);
+  assert(list.try_pop_front().error() == ListError::Empty);
+
+  list.push_back(1);
+  assert(list.try_pop_back().value() == 1);
+  assert(list.try_pop_back().error() == ListError::Empty);
+
   return 0;
 };
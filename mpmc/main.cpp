@@ -0,0 +1,163 @@
+#include "mpmc.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+void test_single_thread() {
+  std::cout << "Testing single-threaded push_back/pop_front..." << std::endl;
+
+  MPMCQueue<int> queue(5);
+  assert(queue.capacity() == 8);
+  assert(queue.empty());
+  assert(!queue.try_pop_front().has_value());
+
+  for (int i = 0; i < 8; ++i) {
+    assert(queue.try_push_back(i));
+  }
+  assert(!queue.try_push_back(8));
+  assert(queue.size() == 8);
+
+  assert(queue.pop_front() == 0);
+  assert(queue.try_pop_front().value() == 1);
+  queue.push_back(8);
+  queue.push_back(9);
+
+  for (int i = 2; i < 10; ++i) {
+    assert(queue.pop_front() == i);
+  }
+  assert(queue.empty());
+}
+
+void test_min_capacity() {
+  std::cout << "Testing smallest capacity..." << std::endl;
+
+  for (std::size_t requested : {0, 1, 2}) {
+    MPMCQueue<int> queue(requested);
+    assert(queue.capacity() == 2);
+
+    for (int lap = 0; lap < 3; ++lap) {
+      assert(queue.try_push_back(2 * lap));
+      assert(queue.try_push_back(2 * lap + 1));
+      assert(!queue.try_push_back(-1));
+      assert(queue.size() == 2);
+      assert(queue.try_pop_front().value() == 2 * lap);
+      assert(queue.try_pop_front().value() == 2 * lap + 1);
+      assert(!queue.try_pop_front().has_value());
+    }
+
+    int in[3] = {7, 8, 9};
+    int out[3] = {};
+    assert(queue.try_push_n(in, 3) == 2);
+    assert(queue.try_pop_n(out, 3) == 2);
+    assert(out[0] == 7 && out[1] == 8);
+  }
+}
+
+void test_batch() {
+  std::cout << "Testing push_n/pop_n..." << std::endl;
+
+  MPMCQueue<int> queue(8);
+  std::vector<int> in(12);
+  std::iota(in.begin(), in.end(), 0);
+
+  assert(queue.try_push_n(in.begin(), 12) == 8);
+  assert(queue.try_push_n(in.begin(), 1) == 0);
+
+  std::vector<int> out(12, -1);
+  assert(queue.try_pop_n(out.begin(), 5) == 5);
+  assert(queue.try_push_n(in.begin() + 8, 4) == 4);
+  assert(queue.try_pop_n(out.begin() + 5, 12) == 7);
+  assert(queue.try_pop_n(out.begin(), 1) == 0);
+  assert(out == in);
+}
+
+void test_move_only() {
+  std::cout << "Testing move-only elements..." << std::endl;
+
+  MPMCQueue<std::unique_ptr<int>> queue(2);
+  queue.push_back(std::make_unique<int>(1));
+  queue.push_back(std::make_unique<int>(2));
+
+  auto full = std::make_unique<int>(3);
+  assert(!queue.try_push_back(std::move(full)));
+  assert(full != nullptr);
+
+  assert(*queue.pop_front() == 1);
+  queue.push_back(std::move(full));
+  assert(*queue.pop_front() == 2);
+  // The remaining element is destroyed with the queue.
+}
+
+template <typename WaitPolicy> void test_concurrent(const char *name) {
+  std::cout << "Testing concurrent producers/consumers (" << name << ")..."
+            << std::endl;
+
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 50000;
+  constexpr int kBatch = 16;
+
+  MPMCQueue<int, WaitPolicy> queue(64);
+  std::atomic<long long> sum = 0;
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&queue, t] {
+      std::vector<int> batch(kBatch);
+      for (int i = 0; i < kPerThread; i += kBatch) {
+        std::iota(batch.begin(), batch.end(), t * kPerThread + i + 1);
+        if (t % 2 == 0) {
+          queue.push_n(batch.begin(), kBatch);
+        } else {
+          for (int val : batch) {
+            queue.push_back(val);
+          }
+        }
+      }
+    });
+    threads.emplace_back([&queue, &sum, t] {
+      long long local = 0;
+      std::vector<int> batch(kBatch);
+      for (int i = 0; i < kPerThread; i += kBatch) {
+        if (t % 2 == 0) {
+          for (int j = 0; j < kBatch; ++j) {
+            local += queue.pop_front();
+          }
+        } else {
+          queue.pop_n(batch.begin(), kBatch);
+          local += std::accumulate(batch.begin(), batch.end(), 0LL);
+        }
+      }
+      sum += local;
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  const long long total = (long long)kThreads * kPerThread;
+  assert(sum == total * (total + 1) / 2);
+  assert(queue.empty());
+}
+
+int main() {
+  try {
+    test_single_thread();
+    test_min_capacity();
+    test_batch();
+    test_move_only();
+    test_concurrent<SpinWait>("SpinWait");
+    test_concurrent<BlockingWait>("BlockingWait");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1 @@
+#include "mpmc.h"
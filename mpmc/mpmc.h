@@ -0,0 +1,359 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+// ============================================================== //
+// ======================== Wait policies ======================= //
+// ============================================================== //
+
+// A policy decides what push_back/pop_front do while the queue is full or
+// empty. The queue keeps one policy object per direction: `prepare()` is
+// called before each attempt, `wait()` after a failed one and `notify()`
+// after every successful operation in the opposite direction.
+
+// Busy-waits, yielding the CPU after a few rounds. Lowest latency, burns a
+// core per waiting thread.
+class SpinWait {
+public:
+  std::uint32_t prepare() const { return 0; }
+
+  void wait(std::uint32_t, unsigned attempt) const {
+    if (attempt >= kSpins) {
+      std::this_thread::yield();
+    }
+  }
+
+  void notify() {}
+
+private:
+  static constexpr unsigned kSpins = 64;
+};
+
+// Spins briefly, then sleeps on an epoch counter bumped by every successful
+// operation in the opposite direction.
+class BlockingWait {
+public:
+  std::uint32_t prepare() const { return d_epoch.load(); }
+
+  void wait(std::uint32_t epoch, unsigned attempt) const {
+    if (attempt >= kSpins) {
+      d_epoch.wait(epoch);
+    }
+  }
+
+  void notify() {
+    d_epoch.fetch_add(1);
+    d_epoch.notify_all();
+  }
+
+private:
+  static constexpr unsigned kSpins = 64;
+
+  std::atomic<std::uint32_t> d_epoch{0};
+};
+
+// ============================================================== //
+// ========================== MPMCQueue ========================= //
+// ============================================================== //
+
+// Bounded multi-producer/multi-consumer queue over a ring of slots, each
+// carrying a sequence number that says whether it is ready to be written or
+// read for a given lap (Vyukov's bounded MPMC queue). Producers claim
+// positions by CAS on the tail, consumers on the head, and the two counters
+// live on separate cache lines. Batch operations claim several consecutive
+// positions with a single CAS.
+//
+// Shares the push_back/pop_front vocabulary of LinkedList and
+// DoubleLinkedList, capacity is rounded up to a power of two, at least 2.
+template <typename T, typename WaitPolicy = SpinWait> class MPMCQueue {
+  struct Slot;
+
+public:
+  explicit MPMCQueue(std::size_t capacity);
+  ~MPMCQueue();
+
+  MPMCQueue(const MPMCQueue &) = delete;
+  MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+  template <typename C = T> bool try_push_back(C &&val);
+  template <typename C = T> void push_back(C &&val);
+
+  std::optional<T> try_pop_front();
+  T pop_front();
+
+  // Push up to `count` elements moved from `first`, returns how many were
+  // pushed. push_n waits until all of them are in.
+  template <typename It> std::size_t try_push_n(It first, std::size_t count);
+  template <typename It> void push_n(It first, std::size_t count);
+
+  // Pop up to `count` elements into `out`, returns how many were popped.
+  // pop_n waits until `count` elements were popped.
+  template <typename Out> std::size_t try_pop_n(Out out, std::size_t count);
+  template <typename Out> void pop_n(Out out, std::size_t count);
+
+  bool empty() const { return size() == 0; }
+  std::size_t size() const;
+  std::size_t capacity() const { return d_mask + 1; }
+
+private:
+  static constexpr std::size_t kCacheLine = 64;
+
+  // Number of consecutive slots from `pos` whose sequence is `pos + i + lag`,
+  // at most `count`.
+  std::size_t ready(std::size_t pos, std::size_t count, std::size_t lag) const;
+
+  std::size_t d_mask;
+  std::unique_ptr<Slot[]> d_slots;
+
+  alignas(kCacheLine) std::atomic<std::size_t> d_tail{0};
+  alignas(kCacheLine) std::atomic<std::size_t> d_head{0};
+  // Producers notify d_not_empty and consumers d_not_full on every
+  // operation, keep them apart like the counters.
+  alignas(kCacheLine) WaitPolicy d_not_full;
+  alignas(kCacheLine) WaitPolicy d_not_empty;
+};
+
+// ============================================================== //
+// ============================ Slot ============================ //
+// ============================================================== //
+
+template <typename T, typename WaitPolicy>
+struct MPMCQueue<T, WaitPolicy>::Slot {
+  std::atomic<std::size_t> seq;
+  alignas(T) unsigned char storage[sizeof(T)];
+
+  T *ptr() { return std::launder(reinterpret_cast<T *>(storage)); }
+};
+
+// ============================================================== //
+// ========================== MPMCQueue ========================= //
+// ============================================================== //
+
+template <typename T, typename WaitPolicy>
+MPMCQueue<T, WaitPolicy>::MPMCQueue(std::size_t capacity) {
+  // With a single slot a written slot's sequence (pos + 1) equals the next
+  // lap's position, so producers would overwrite an unread element.
+  std::size_t rounded = 2;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+
+  d_mask = rounded - 1;
+  d_slots.reset(new Slot[rounded]);
+  for (std::size_t i = 0; i < rounded; ++i) {
+    d_slots[i].seq.store(i, std::memory_order_relaxed);
+  }
+}
+
+template <typename T, typename WaitPolicy>
+MPMCQueue<T, WaitPolicy>::~MPMCQueue() {
+  while (try_pop_front()) {
+  }
+}
+
+template <typename T, typename WaitPolicy>
+std::size_t MPMCQueue<T, WaitPolicy>::ready(std::size_t pos, std::size_t count,
+                                            std::size_t lag) const {
+  count = count < capacity() ? count : capacity();
+  for (std::size_t i = 0; i < count; ++i) {
+    const Slot &slot = d_slots[(pos + i) & d_mask];
+    if (slot.seq.load(std::memory_order_acquire) != pos + i + lag) {
+      return i;
+    }
+  }
+  return count;
+}
+
+template <typename T, typename WaitPolicy>
+template <typename C>
+bool MPMCQueue<T, WaitPolicy>::try_push_back(C &&val) {
+  std::size_t pos = d_tail.load(std::memory_order_relaxed);
+  while (true) {
+    Slot &slot = d_slots[pos & d_mask];
+    std::size_t seq = slot.seq.load(std::memory_order_acquire);
+    auto diff = std::intptr_t(seq) - std::intptr_t(pos);
+
+    if (diff == 0) {
+      if (d_tail.compare_exchange_weak(pos, pos + 1,
+                                       std::memory_order_relaxed)) {
+        new (slot.storage) T(std::forward<C>(val));
+        slot.seq.store(pos + 1, std::memory_order_release);
+        d_not_empty.notify();
+        return true;
+      }
+    } else if (diff < 0) {
+      // The slot still holds last lap's element, the queue is full.
+      return false;
+    } else {
+      pos = d_tail.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename T, typename WaitPolicy>
+template <typename C>
+void MPMCQueue<T, WaitPolicy>::push_back(C &&val) {
+  for (unsigned attempt = 0;; ++attempt) {
+    std::uint32_t epoch = d_not_full.prepare();
+    if (try_push_back(std::forward<C>(val))) {
+      return;
+    }
+    d_not_full.wait(epoch, attempt);
+  }
+}
+
+template <typename T, typename WaitPolicy>
+std::optional<T> MPMCQueue<T, WaitPolicy>::try_pop_front() {
+  std::size_t pos = d_head.load(std::memory_order_relaxed);
+  while (true) {
+    Slot &slot = d_slots[pos & d_mask];
+    std::size_t seq = slot.seq.load(std::memory_order_acquire);
+    auto diff = std::intptr_t(seq) - std::intptr_t(pos + 1);
+
+    if (diff == 0) {
+      if (d_head.compare_exchange_weak(pos, pos + 1,
+                                       std::memory_order_relaxed)) {
+        std::optional<T> val(std::move(*slot.ptr()));
+        slot.ptr()->~T();
+        slot.seq.store(pos + capacity(), std::memory_order_release);
+        d_not_full.notify();
+        return val;
+      }
+    } else if (diff < 0) {
+      // The slot has not been written for this lap yet, the queue is empty.
+      return std::nullopt;
+    } else {
+      pos = d_head.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename T, typename WaitPolicy>
+T MPMCQueue<T, WaitPolicy>::pop_front() {
+  for (unsigned attempt = 0;; ++attempt) {
+    std::uint32_t epoch = d_not_empty.prepare();
+    if (auto val = try_pop_front()) {
+      return std::move(*val);
+    }
+    d_not_empty.wait(epoch, attempt);
+  }
+}
+
+template <typename T, typename WaitPolicy>
+template <typename It>
+std::size_t MPMCQueue<T, WaitPolicy>::try_push_n(It first,
+                                                 std::size_t count) {
+  if (count == 0) {
+    return 0;
+  }
+
+  std::size_t pos = d_tail.load(std::memory_order_relaxed);
+  std::size_t claimed = 0;
+  while (true) {
+    claimed = ready(pos, count, 0);
+    if (claimed == 0) {
+      std::size_t seq = d_slots[pos & d_mask].seq.load();
+      if (std::intptr_t(seq) - std::intptr_t(pos) < 0) {
+        return 0;
+      }
+      pos = d_tail.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (d_tail.compare_exchange_weak(pos, pos + claimed,
+                                     std::memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  for (std::size_t i = 0; i < claimed; ++i, ++first) {
+    Slot &slot = d_slots[(pos + i) & d_mask];
+    new (slot.storage) T(std::move(*first));
+    slot.seq.store(pos + i + 1, std::memory_order_release);
+  }
+  d_not_empty.notify();
+  return claimed;
+}
+
+template <typename T, typename WaitPolicy>
+template <typename It>
+void MPMCQueue<T, WaitPolicy>::push_n(It first, std::size_t count) {
+  unsigned attempt = 0;
+  while (count > 0) {
+    std::uint32_t epoch = d_not_full.prepare();
+    std::size_t pushed = try_push_n(first, count);
+    if (pushed == 0) {
+      d_not_full.wait(epoch, attempt++);
+      continue;
+    }
+    std::advance(first, pushed);
+    count -= pushed;
+    attempt = 0;
+  }
+}
+
+template <typename T, typename WaitPolicy>
+template <typename Out>
+std::size_t MPMCQueue<T, WaitPolicy>::try_pop_n(Out out, std::size_t count) {
+  if (count == 0) {
+    return 0;
+  }
+
+  std::size_t pos = d_head.load(std::memory_order_relaxed);
+  std::size_t claimed = 0;
+  while (true) {
+    claimed = ready(pos, count, 1);
+    if (claimed == 0) {
+      std::size_t seq = d_slots[pos & d_mask].seq.load();
+      if (std::intptr_t(seq) - std::intptr_t(pos + 1) < 0) {
+        return 0;
+      }
+      pos = d_head.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (d_head.compare_exchange_weak(pos, pos + claimed,
+                                     std::memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  for (std::size_t i = 0; i < claimed; ++i, ++out) {
+    Slot &slot = d_slots[(pos + i) & d_mask];
+    *out = std::move(*slot.ptr());
+    slot.ptr()->~T();
+    slot.seq.store(pos + i + capacity(), std::memory_order_release);
+  }
+  d_not_full.notify();
+  return claimed;
+}
+
+template <typename T, typename WaitPolicy>
+template <typename Out>
+void MPMCQueue<T, WaitPolicy>::pop_n(Out out, std::size_t count) {
+  unsigned attempt = 0;
+  while (count > 0) {
+    std::uint32_t epoch = d_not_empty.prepare();
+    std::size_t popped = try_pop_n(out, count);
+    if (popped == 0) {
+      d_not_empty.wait(epoch, attempt++);
+      continue;
+    }
+    std::advance(out, popped);
+    count -= popped;
+    attempt = 0;
+  }
+}
+
+template <typename T, typename WaitPolicy>
+std::size_t MPMCQueue<T, WaitPolicy>::size() const {
+  std::size_t head = d_head.load(std::memory_order_relaxed);
+  std::size_t tail = d_tail.load(std::memory_order_relaxed);
+  return tail > head ? tail - head : 0;
+}
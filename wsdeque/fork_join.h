@@ -0,0 +1,43 @@
+#pragma once
+
+#include "scheduler.h"
+#include <cstddef>
+#include <numeric>
+
+// Fork-join kernels used by the scheduler test and fork_join_bench. Both
+// must run inside Scheduler::run(). Below `cutoff`/`grain` they fall back to
+// serial code, so the cost of a spawn stays small next to the work it
+// carries.
+
+inline long serial_fib(int n) {
+  return n < 2 ? n : serial_fib(n - 1) + serial_fib(n - 2);
+}
+
+inline long fib(int n, int cutoff) {
+  if (n < cutoff) {
+    return serial_fib(n);
+  }
+
+  long a = 0;
+  TaskGroup group;
+  group.spawn([&a, n, cutoff] { a = fib(n - 1, cutoff); });
+  long b = fib(n - 2, cutoff);
+  group.wait();
+  return a + b;
+}
+
+inline long long parallel_sum(const int *data, std::size_t count,
+                              std::size_t grain) {
+  if (count <= grain) {
+    return std::accumulate(data, data + count, 0LL);
+  }
+
+  long long left = 0;
+  TaskGroup group;
+  group.spawn([&left, data, count, grain] {
+    left = parallel_sum(data, count / 2, grain);
+  });
+  long long right = parallel_sum(data + count / 2, count - count / 2, grain);
+  group.wait();
+  return left + right;
+}
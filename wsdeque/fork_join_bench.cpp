@@ -0,0 +1,70 @@
+#include "../common/do_not_optimize.h"
+#include "fork_join.h"
+#include "scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+// Recursive fib and parallel sum on the work-stealing Scheduler, run with
+// 1, 2, 4, ... workers up to the hardware concurrency or the first argument.
+// Prints CSV with the wall time and the speedup over a single worker.
+//
+//   fork_join_bench [max_workers]
+
+constexpr int kFibN = 34;
+constexpr int kFibCutoff = 18;
+constexpr std::size_t kSumCount = std::size_t(1) << 26;
+constexpr std::size_t kSumGrain = std::size_t(1) << 15;
+
+template <typename F> double time_ms(Scheduler &scheduler, F fn) {
+  double best = 0;
+  for (int rep = 0; rep < 3; ++rep) {
+    auto start = std::chrono::steady_clock::now();
+    scheduler.run(fn);
+    auto stop = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+    best = rep == 0 ? ms : std::min(best, ms);
+  }
+  return best;
+}
+
+int main(int argc, char **argv) {
+  std::vector<int> data(kSumCount);
+  std::iota(data.begin(), data.end(), 0);
+
+  std::size_t max_workers = std::max(1u, std::thread::hardware_concurrency());
+  if (argc > 1) {
+    max_workers = std::max(1, std::atoi(argv[1]));
+  }
+
+  std::vector<std::size_t> worker_counts;
+  for (std::size_t workers = 1; workers < max_workers; workers *= 2) {
+    worker_counts.push_back(workers);
+  }
+  worker_counts.push_back(max_workers);
+
+  std::printf("benchmark,workers,ms,speedup\n");
+  double fib_base = 0;
+  double sum_base = 0;
+  for (std::size_t workers : worker_counts) {
+    Scheduler scheduler(workers);
+
+    double fib_ms = time_ms(
+        scheduler, [] { do_not_optimize(fib(kFibN, kFibCutoff)); });
+    double sum_ms = time_ms(scheduler, [&data] {
+      do_not_optimize(parallel_sum(data.data(), data.size(), kSumGrain));
+    });
+
+    if (workers == 1) {
+      fib_base = fib_ms;
+      sum_base = sum_ms;
+    }
+    std::printf("fib,%zu,%.2f,%.2f\n", workers, fib_ms, fib_base / fib_ms);
+    std::printf("sum,%zu,%.2f,%.2f\n", workers, sum_ms, sum_base / sum_ms);
+  }
+  return 0;
+}
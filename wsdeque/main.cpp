@@ -0,0 +1,124 @@
+#include "fork_join.h"
+#include "scheduler.h"
+#include "wsdeque.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+void test_owner_operations() {
+  std::cout << "Testing owner push_back/pop_back..." << std::endl;
+
+  WorkStealingDeque<int> deque(4);
+  assert(deque.empty());
+  assert(!deque.pop_back().has_value());
+  assert(!deque.steal_front().has_value());
+
+  for (int i = 0; i < 100; ++i) {
+    deque.push_back(i);
+  }
+  assert(deque.size() == 100);
+  assert(deque.capacity() >= 100);
+
+  assert(deque.pop_back().value() == 99);
+  assert(deque.steal_front().value() == 0);
+  assert(deque.steal_front().value() == 1);
+  assert(deque.pop_back().value() == 98);
+  assert(deque.size() == 96);
+
+  while (deque.pop_back()) {
+  }
+  assert(deque.empty());
+}
+
+void test_concurrent_steal() {
+  std::cout << "Testing concurrent steal_front..." << std::endl;
+
+  constexpr int kItems = 200000;
+  constexpr int kThieves = 3;
+
+  WorkStealingDeque<int> deque(16);
+  std::atomic<bool> done = false;
+  std::atomic<long long> stolen_sum = 0;
+  std::atomic<int> stolen_count = 0;
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < kThieves; ++i) {
+    thieves.emplace_back([&] {
+      while (!done.load() || !deque.empty()) {
+        if (auto val = deque.steal_front()) {
+          stolen_sum += *val;
+          ++stolen_count;
+        }
+      }
+    });
+  }
+
+  long long owner_sum = 0;
+  int owner_count = 0;
+  for (int i = 1; i <= kItems; ++i) {
+    deque.push_back(i);
+    if (i % 3 == 0) {
+      if (auto val = deque.pop_back()) {
+        owner_sum += *val;
+        ++owner_count;
+      }
+    }
+  }
+  while (auto val = deque.pop_back()) {
+    owner_sum += *val;
+    ++owner_count;
+  }
+  done = true;
+
+  for (auto &thief : thieves) {
+    thief.join();
+  }
+
+  assert(owner_count + stolen_count == kItems);
+  assert(owner_sum + stolen_sum == (long long)kItems * (kItems + 1) / 2);
+}
+
+void test_scheduler() {
+  std::cout << "Testing fork-join Scheduler..." << std::endl;
+
+  Scheduler scheduler(4);
+  assert(scheduler.worker_count() == 4);
+
+  long result = 0;
+  scheduler.run([&result] { result = fib(25, 12); });
+  assert(result == 75025);
+
+  std::vector<int> data(1 << 20);
+  std::iota(data.begin(), data.end(), 0);
+  long long sum = 0;
+  scheduler.run(
+      [&] { sum = parallel_sum(data.data(), data.size(), 4096); });
+  assert(sum == (long long)(data.size() * (data.size() - 1) / 2));
+
+  bool threw = false;
+  try {
+    TaskGroup group;
+    group.spawn([] {});
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+int main() {
+  try {
+    test_owner_operations();
+    test_concurrent_steal();
+    test_scheduler();
+
+    std::cout << "All tests passed successfully!" << std::endl;
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+#include "scheduler.h"
+#include <stdexcept>
+
+namespace {
+
+std::uint32_t next_random(std::uint32_t &seed) {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+} // namespace
+
+// ============================================================== //
+// ========================= TaskGroup ========================== //
+// ============================================================== //
+
+void TaskGroup::wait() {
+  while (d_pending.load(std::memory_order_acquire) != 0) {
+    if (!Scheduler::help()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// ============================================================== //
+// ========================= Scheduler ========================== //
+// ============================================================== //
+
+thread_local Scheduler::Worker *Scheduler::s_current = nullptr;
+
+Scheduler::Scheduler(std::size_t workers) {
+  if (workers == 0) {
+    workers = 1;
+  }
+
+  for (std::size_t i = 0; i < workers; ++i) {
+    auto worker = std::make_unique<Worker>();
+    worker->scheduler = this;
+    worker->seed = std::uint32_t(i * 2654435761u + 1);
+    d_workers.push_back(std::move(worker));
+  }
+
+  for (std::size_t i = 1; i < workers; ++i) {
+    d_threads.emplace_back([this, i] { worker_loop(i); });
+  }
+}
+
+Scheduler::~Scheduler() {
+  {
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_stop = true;
+  }
+  d_wake.notify_all();
+
+  for (auto &thread : d_threads) {
+    thread.join();
+  }
+}
+
+void Scheduler::enter() {
+  if (s_current != nullptr) {
+    throw std::runtime_error("Scheduler::run() cannot be nested");
+  }
+  s_current = d_workers[0].get();
+
+  {
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_active.store(true);
+  }
+  d_wake.notify_all();
+}
+
+void Scheduler::leave() {
+  d_active.store(false);
+  s_current = nullptr;
+}
+
+void Scheduler::worker_loop(std::size_t idx) {
+  Worker &self = *d_workers[idx];
+  s_current = &self;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(d_mutex);
+      d_wake.wait(lock, [this] { return d_stop || d_active.load(); });
+      if (d_stop) {
+        return;
+      }
+    }
+
+    while (d_active.load(std::memory_order_relaxed)) {
+      if (!execute_one(self)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+}
+
+void Scheduler::spawn(Task *task) {
+  Worker *worker = s_current;
+  if (worker == nullptr) {
+    task->d_group->d_pending.fetch_sub(1, std::memory_order_relaxed);
+    delete task;
+    throw std::runtime_error("TaskGroup::spawn() outside Scheduler::run()");
+  }
+  worker->deque.push_back(task);
+}
+
+bool Scheduler::help() {
+  Worker *worker = s_current;
+  if (worker == nullptr) {
+    return false;
+  }
+  return worker->scheduler->execute_one(*worker);
+}
+
+bool Scheduler::execute_one(Worker &self) {
+  if (auto task = self.deque.pop_back()) {
+    execute(*task);
+    return true;
+  }
+
+  const std::size_t count = d_workers.size();
+  for (std::size_t attempt = 0; attempt < count; ++attempt) {
+    Worker &victim = *d_workers[next_random(self.seed) % count];
+    if (&victim == &self) {
+      continue;
+    }
+    if (auto task = victim.deque.steal_front()) {
+      execute(*task);
+      return true;
+    }
+  }
+  return false;
+}
+
+void Scheduler::execute(Task *task) {
+  TaskGroup *group = task->d_group;
+  task->run();
+  delete task;
+  group->d_pending.fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "wsdeque.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class Scheduler;
+class TaskGroup;
+
+// ============================================================== //
+// ============================ Task ============================ //
+// ============================================================== //
+
+class Task {
+  friend Scheduler;
+
+public:
+  explicit Task(TaskGroup &group) : d_group(&group) {}
+  virtual ~Task() = default;
+
+  virtual void run() = 0;
+
+private:
+  TaskGroup *d_group;
+};
+
+template <typename F> class FunctionTask : public Task {
+private:
+  F d_fn;
+
+public:
+  FunctionTask(TaskGroup &group, F fn) : Task(group), d_fn(std::move(fn)) {}
+
+  void run() override { d_fn(); }
+};
+
+// ============================================================== //
+// ========================= TaskGroup ========================== //
+// ============================================================== //
+
+// Fork-join scope. Tasks spawned into a group are pushed onto the calling
+// worker's deque, `wait()` runs local and stolen tasks until every task of
+// the group has finished. Must be used from inside `Scheduler::run`, and
+// tasks must not throw.
+class TaskGroup {
+  friend Scheduler;
+
+public:
+  TaskGroup() = default;
+  ~TaskGroup() { wait(); }
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  template <typename F> void spawn(F fn);
+  void wait();
+
+private:
+  std::atomic<std::size_t> d_pending{0};
+};
+
+// ============================================================== //
+// ========================= Scheduler ========================== //
+// ============================================================== //
+
+// Fixed set of workers, each owning a WorkStealingDeque. Worker 0 is the
+// thread calling `run`, the others sleep between runs and steal from random
+// victims while a run is active. Only one thread may call `run` at a time.
+class Scheduler {
+  friend TaskGroup;
+
+public:
+  explicit Scheduler(
+      std::size_t workers = std::thread::hardware_concurrency());
+  ~Scheduler();
+
+  Scheduler(const Scheduler &) = delete;
+  Scheduler &operator=(const Scheduler &) = delete;
+
+  template <typename F> void run(F fn);
+
+  std::size_t worker_count() const { return d_workers.size(); }
+
+private:
+  struct Worker {
+    WorkStealingDeque<Task *> deque;
+    Scheduler *scheduler = nullptr;
+    std::uint32_t seed = 1;
+  };
+
+  // Worker state of the calling thread, null outside of a Scheduler.
+  static thread_local Worker *s_current;
+
+  static void spawn(Task *task);
+  static bool help();
+
+  void enter();
+  void leave();
+  void worker_loop(std::size_t idx);
+  bool execute_one(Worker &self);
+  void execute(Task *task);
+
+  std::vector<std::unique_ptr<Worker>> d_workers;
+  std::vector<std::thread> d_threads;
+  std::atomic<bool> d_active{false};
+  bool d_stop = false;
+  std::mutex d_mutex;
+  std::condition_variable d_wake;
+};
+
+template <typename F> void TaskGroup::spawn(F fn) {
+  d_pending.fetch_add(1, std::memory_order_relaxed);
+  Scheduler::spawn(new FunctionTask<F>(*this, std::move(fn)));
+}
+
+template <typename F> void Scheduler::run(F fn) {
+  enter();
+  try {
+    fn();
+  } catch (...) {
+    leave();
+    throw;
+  }
+  leave();
+}
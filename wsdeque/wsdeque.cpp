@@ -0,0 +1 @@
+#include "wsdeque.h"
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// ============================================================== //
+// ===================== WorkStealingDeque ====================== //
+// ============================================================== //
+
+// Chase-Lev work-stealing deque (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models"). The owning thread pushes and pops
+// at the back without locks, any other thread may steal from the front with
+// a single CAS. The circular buffer doubles when full, replaced buffers are
+// kept alive until the deque is destroyed since thieves may still read them.
+//
+// T is copied through std::atomic so it must be trivially copyable, in
+// practice a pointer to a task.
+template <typename T> class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "WorkStealingDeque elements must be trivially copyable");
+
+  class Buffer;
+
+public:
+  explicit WorkStealingDeque(std::size_t capacity = 64);
+  ~WorkStealingDeque();
+
+  WorkStealingDeque(const WorkStealingDeque &) = delete;
+  WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+  // Owner only.
+  void push_back(T val);
+  std::optional<T> pop_back();
+
+  // Any thread. Returns nullopt when empty or when losing a race.
+  std::optional<T> steal_front();
+
+  bool empty() const;
+  std::size_t size() const;
+  std::size_t capacity() const;
+
+private:
+  Buffer *grow(Buffer *buffer, std::int64_t top, std::int64_t bottom);
+
+  alignas(64) std::atomic<std::int64_t> d_top{0};
+  alignas(64) std::atomic<std::int64_t> d_bottom{0};
+  std::atomic<Buffer *> d_buffer;
+  std::vector<std::unique_ptr<Buffer>> d_retired;
+};
+
+// ============================================================== //
+// =========================== Buffer =========================== //
+// ============================================================== //
+
+template <typename T> class WorkStealingDeque<T>::Buffer {
+private:
+  std::int64_t d_mask;
+  std::unique_ptr<std::atomic<T>[]> d_slots;
+
+public:
+  explicit Buffer(std::int64_t capacity)
+      : d_mask(capacity - 1), d_slots(new std::atomic<T>[capacity]) {}
+
+  std::int64_t capacity() const { return d_mask + 1; }
+
+  T get(std::int64_t idx) const {
+    return d_slots[idx & d_mask].load(std::memory_order_relaxed);
+  }
+
+  void put(std::int64_t idx, T val) {
+    d_slots[idx & d_mask].store(val, std::memory_order_relaxed);
+  }
+};
+
+// ============================================================== //
+// ===================== WorkStealingDeque ====================== //
+// ============================================================== //
+
+template <typename T>
+WorkStealingDeque<T>::WorkStealingDeque(std::size_t capacity) {
+  std::size_t rounded = 1;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+  d_buffer.store(new Buffer(std::int64_t(rounded)), std::memory_order_relaxed);
+}
+
+template <typename T> WorkStealingDeque<T>::~WorkStealingDeque() {
+  delete d_buffer.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+typename WorkStealingDeque<T>::Buffer *
+WorkStealingDeque<T>::grow(Buffer *buffer, std::int64_t top,
+                           std::int64_t bottom) {
+  Buffer *bigger = new Buffer(buffer->capacity() * 2);
+  for (std::int64_t i = top; i < bottom; ++i) {
+    bigger->put(i, buffer->get(i));
+  }
+
+  d_retired.emplace_back(buffer);
+  d_buffer.store(bigger, std::memory_order_release);
+  return bigger;
+}
+
+template <typename T> void WorkStealingDeque<T>::push_back(T val) {
+  std::int64_t bottom = d_bottom.load(std::memory_order_relaxed);
+  std::int64_t top = d_top.load(std::memory_order_acquire);
+  Buffer *buffer = d_buffer.load(std::memory_order_relaxed);
+
+  if (bottom - top > buffer->capacity() - 1) {
+    buffer = grow(buffer, top, bottom);
+  }
+
+  buffer->put(bottom, val);
+  d_bottom.store(bottom + 1, std::memory_order_release);
+}
+
+template <typename T> std::optional<T> WorkStealingDeque<T>::pop_back() {
+  std::int64_t bottom = d_bottom.load(std::memory_order_relaxed) - 1;
+  Buffer *buffer = d_buffer.load(std::memory_order_relaxed);
+  d_bottom.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t top = d_top.load(std::memory_order_relaxed);
+
+  if (top > bottom) {
+    // Empty, restore bottom.
+    d_bottom.store(bottom + 1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  T val = buffer->get(bottom);
+  if (top == bottom) {
+    // Last element, race against thieves for it.
+    bool won = d_top.compare_exchange_strong(top, top + 1,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_relaxed);
+    d_bottom.store(bottom + 1, std::memory_order_relaxed);
+    if (!won) {
+      return std::nullopt;
+    }
+  }
+  return val;
+}
+
+template <typename T> std::optional<T> WorkStealingDeque<T>::steal_front() {
+  std::int64_t top = d_top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t bottom = d_bottom.load(std::memory_order_acquire);
+
+  if (top >= bottom) {
+    return std::nullopt;
+  }
+
+  Buffer *buffer = d_buffer.load(std::memory_order_acquire);
+  T val = buffer->get(top);
+  if (!d_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+    return std::nullopt;
+  }
+  return val;
+}
+
+template <typename T> bool WorkStealingDeque<T>::empty() const {
+  return size() == 0;
+}
+
+template <typename T> std::size_t WorkStealingDeque<T>::size() const {
+  std::int64_t bottom = d_bottom.load(std::memory_order_relaxed);
+  std::int64_t top = d_top.load(std::memory_order_relaxed);
+  return bottom > top ? std::size_t(bottom - top) : 0;
+}
+
+template <typename T> std::size_t WorkStealingDeque<T>::capacity() const {
+  return std::size_t(d_buffer.load(std::memory_order_relaxed)->capacity());
+}